@@ -0,0 +1,666 @@
+#include "Benchmark.h"
+#include "NodeHeap.h"
+#include "BucketQueue.h"
+#include "Pathfinding.h"
+#include "MovingAI.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    // Standalone 4-connected cost grid; 0 marks a blocked cell
+    struct BenchGrid
+    {
+        int size;
+        std::vector<unsigned char> cost;
+    };
+
+    struct BenchQuery
+    {
+        int start, goal;
+    };
+
+    struct BenchStats
+    {
+        double seconds = 0.0;
+        long long expansions = 0;
+        long long pushes = 0;
+        long long stalePops = 0;
+        long long decreaseKeys = 0;
+        double totalCost = 0.0;
+    };
+
+    BenchGrid MakeGrid(int size, int maxCost, unsigned int seed)
+    {
+        BenchGrid grid;
+        grid.size = size;
+        grid.cost.resize(static_cast<size_t>(size) * size);
+
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<int> costDist(1, maxCost);
+        std::uniform_real_distribution<float> blockDist(0.0f, 1.0f);
+
+        for (unsigned char& c : grid.cost)
+            c = blockDist(rng) < 0.2f ? 0 : static_cast<unsigned char>(costDist(rng));
+
+        return grid;
+    }
+
+    std::vector<BenchQuery> MakeQueries(const BenchGrid& grid, int count, unsigned int seed)
+    {
+        std::mt19937 rng(seed ^ 0x9e3779b9u);
+        std::uniform_int_distribution<int> cellDist(0, grid.size * grid.size - 1);
+
+        std::vector<BenchQuery> queries;
+        while (static_cast<int>(queries.size()) < count)
+        {
+            BenchQuery q = { cellDist(rng), cellDist(rng) };
+            if (grid.cost[q.start] != 0 && grid.cost[q.goal] != 0)
+                queries.push_back(q);
+        }
+        return queries;
+    }
+
+    inline float Manhattan(const BenchGrid& grid, int a, int b)
+    {
+        return static_cast<float>(std::abs(a / grid.size - b / grid.size) + std::abs(a % grid.size - b % grid.size));
+    }
+
+    // Calls visit(neighborCell) for every passable 4-neighbor of cell
+    template <typename Visit>
+    inline void ForEachNeighbor(const BenchGrid& grid, int cell, Visit visit)
+    {
+        int x = cell / grid.size;
+        int z = cell % grid.size;
+        if (x > 0 && grid.cost[cell - grid.size]) visit(cell - grid.size);
+        if (x < grid.size - 1 && grid.cost[cell + grid.size]) visit(cell + grid.size);
+        if (z > 0 && grid.cost[cell - 1]) visit(cell - 1);
+        if (z < grid.size - 1 && grid.cost[cell + 1]) visit(cell + 1);
+    }
+
+    BenchStats RunIndexedHeap(const BenchGrid& grid, const std::vector<BenchQuery>& queries, bool useHeuristic)
+    {
+        BenchStats stats;
+        std::vector<Node> nodes(grid.cost.size());
+        NodeHeap open;
+        unsigned int generation = 0;
+
+        auto begin = std::chrono::high_resolution_clock::now();
+        for (const BenchQuery& q : queries)
+        {
+            generation++;
+            open.Clear();
+
+            Node& start = nodes[q.start];
+            start.gCost = 0.0f;
+            start.fCost = useHeuristic ? Manhattan(grid, q.start, q.goal) : 0.0f;
+            start.generation = generation;
+            start.listState = NODE_OPEN;
+            open.Push(nodes, q.start);
+            stats.pushes++;
+
+            while (!open.Empty())
+            {
+                int cell = static_cast<int>(open.Pop(nodes));
+                Node& current = nodes[cell];
+                current.listState = NODE_CLOSED;
+                stats.expansions++;
+
+                if (cell == q.goal)
+                {
+                    stats.totalCost += current.gCost;
+                    break;
+                }
+
+                ForEachNeighbor(grid, cell, [&](int next)
+                {
+                    Node& n = nodes[next];
+                    float g = current.gCost + grid.cost[next];
+                    if (n.generation != generation)
+                    {
+                        n.generation = generation;
+                        n.listState = NODE_OPEN;
+                        n.gCost = g;
+                        n.hCost = useHeuristic ? Manhattan(grid, next, q.goal) : 0.0f;
+                        n.fCost = g + n.hCost;
+                        open.Push(nodes, next);
+                        stats.pushes++;
+                    }
+                    else if (n.listState == NODE_OPEN && g < n.gCost)
+                    {
+                        n.gCost = g;
+                        n.fCost = g + n.hCost;
+                        open.DecreaseKey(nodes, next);
+                        stats.decreaseKeys++;
+                    }
+                });
+            }
+        }
+        stats.seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - begin).count();
+        return stats;
+    }
+
+    BenchStats RunLazyDeletion(const BenchGrid& grid, const std::vector<BenchQuery>& queries, bool useHeuristic)
+    {
+        typedef std::pair<float, int> Entry;
+
+        BenchStats stats;
+        std::vector<float> gCost(grid.cost.size());
+        std::vector<unsigned int> seen(grid.cost.size(), 0);
+        std::vector<unsigned int> closed(grid.cost.size(), 0);
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+        unsigned int generation = 0;
+
+        auto begin = std::chrono::high_resolution_clock::now();
+        for (const BenchQuery& q : queries)
+        {
+            generation++;
+            open = std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>>();
+
+            gCost[q.start] = 0.0f;
+            seen[q.start] = generation;
+            open.push(Entry(useHeuristic ? Manhattan(grid, q.start, q.goal) : 0.0f, q.start));
+            stats.pushes++;
+
+            while (!open.empty())
+            {
+                int cell = open.top().second;
+                open.pop();
+
+                // Superseded duplicate of an already closed cell
+                if (closed[cell] == generation)
+                {
+                    stats.stalePops++;
+                    continue;
+                }
+                closed[cell] = generation;
+                stats.expansions++;
+
+                if (cell == q.goal)
+                {
+                    stats.totalCost += gCost[cell];
+                    break;
+                }
+
+                ForEachNeighbor(grid, cell, [&](int next)
+                {
+                    if (closed[next] == generation)
+                        return;
+
+                    float g = gCost[cell] + grid.cost[next];
+                    if (seen[next] != generation || g < gCost[next])
+                    {
+                        seen[next] = generation;
+                        gCost[next] = g;
+                        open.push(Entry(g + (useHeuristic ? Manhattan(grid, next, q.goal) : 0.0f), next));
+                        stats.pushes++;
+                    }
+                });
+            }
+        }
+        stats.seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - begin).count();
+        return stats;
+    }
+
+    BenchStats RunBucketQueue(const BenchGrid& grid, const std::vector<BenchQuery>& queries, int maxCost)
+    {
+        BenchStats stats;
+        std::vector<int> gCost(grid.cost.size());
+        std::vector<unsigned int> seen(grid.cost.size(), 0);
+        std::vector<unsigned int> closed(grid.cost.size(), 0);
+        BucketQueue open;
+        unsigned int generation = 0;
+
+        auto begin = std::chrono::high_resolution_clock::now();
+        for (const BenchQuery& q : queries)
+        {
+            generation++;
+            open.Reset(maxCost);
+
+            gCost[q.start] = 0;
+            seen[q.start] = generation;
+            open.Push(q.start, 0);
+            stats.pushes++;
+
+            while (!open.Empty())
+            {
+                int cell = static_cast<int>(open.Pop());
+                if (closed[cell] == generation)
+                {
+                    stats.stalePops++;
+                    continue;
+                }
+                closed[cell] = generation;
+                stats.expansions++;
+
+                if (cell == q.goal)
+                {
+                    stats.totalCost += gCost[cell];
+                    break;
+                }
+
+                ForEachNeighbor(grid, cell, [&](int next)
+                {
+                    if (closed[next] == generation)
+                        return;
+
+                    int g = gCost[cell] + grid.cost[next];
+                    if (seen[next] != generation || g < gCost[next])
+                    {
+                        seen[next] = generation;
+                        gCost[next] = g;
+                        open.Push(next, g);
+                        stats.pushes++;
+                    }
+                });
+            }
+        }
+        stats.seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - begin).count();
+        return stats;
+    }
+
+    void PrintStats(const char* name, const BenchStats& stats)
+    {
+        double rate = stats.seconds > 0.0 ? stats.expansions / stats.seconds / 1e6 : 0.0;
+        std::cout << "  " << name
+                  << ": " << stats.seconds * 1000.0 << " ms"
+                  << ", " << rate << " M expansions/s"
+                  << ", expansions " << stats.expansions
+                  << ", pushes " << stats.pushes
+                  << ", decrease-keys " << stats.decreaseKeys
+                  << ", stale pops " << stats.stalePops
+                  << ", total cost " << stats.totalCost << "\n";
+    }
+
+    struct AlgorithmOption
+    {
+        const char* name;
+        AlgorithmType algorithm;
+    };
+
+    const AlgorithmOption ALGORITHM_OPTIONS[] = {
+        { "dijkstra", ALGORITHM_DIJKSTRA },
+        { "astar", ALGORITHM_ASTAR },
+        { "dial", ALGORITHM_DIAL },
+        { "jps", ALGORITHM_JPS },
+        { "jpsplus", ALGORITHM_JPS_PLUS },
+        { "bidijkstra", ALGORITHM_BIDIRECTIONAL_DIJKSTRA },
+        { "biastar", ALGORITHM_BIDIRECTIONAL_ASTAR },
+        { "hpa", ALGORITHM_HPA }
+    };
+
+    bool IsEightConnected(AlgorithmType algorithm)
+    {
+        return algorithm == ALGORITHM_JPS || algorithm == ALGORITHM_JPS_PLUS;
+    }
+
+    // Scenario maps are named relative to some benchmark root; look next to the .scen first
+    std::string ResolveScenarioMap(const std::string& scenarioPath, const std::string& map)
+    {
+        size_t slash = scenarioPath.find_last_of("/\\");
+        std::string dir = slash == std::string::npos ? std::string() : scenarioPath.substr(0, slash + 1);
+        size_t mapSlash = map.find_last_of("/\\");
+        std::string name = mapSlash == std::string::npos ? map : map.substr(mapSlash + 1);
+        return dir + name;
+    }
+
+    const char* GetLayoutName(GridLayout layout)
+    {
+        switch (layout)
+        {
+        case LAYOUT_MORTON: return "Morton";
+        case LAYOUT_PADDED: return "padded row-major";
+        default:            return "row-major";
+        }
+    }
+
+    // Hardware miss counters are not portable, so count how often a step to a
+    // 4-neighbor lands on another cache line or page of the node pool instead
+    void PrintLayoutLocality(const Grid& grid)
+    {
+        const long long lineBytes = 64;
+        const long long pageBytes = 4096;
+        const long long nodeBytes = sizeof(Node);
+        long long pairs = 0, lineCrossings = 0, pageCrossings = 0;
+
+        for (int x = 0; x < grid.GetWidth(); x++)
+        {
+            for (int z = 0; z < grid.GetDepth(); z++)
+            {
+                long long a = grid.GetCellId(x, z) * nodeBytes;
+                if (x + 1 < grid.GetWidth())
+                {
+                    long long b = grid.GetCellId(x + 1, z) * nodeBytes;
+                    pairs++;
+                    lineCrossings += a / lineBytes != b / lineBytes;
+                    pageCrossings += a / pageBytes != b / pageBytes;
+                }
+                if (z + 1 < grid.GetDepth())
+                {
+                    long long b = grid.GetCellId(x, z + 1) * nodeBytes;
+                    pairs++;
+                    lineCrossings += a / lineBytes != b / lineBytes;
+                    pageCrossings += a / pageBytes != b / pageBytes;
+                }
+            }
+        }
+
+        std::cout << "  neighbor steps to another cache line " << 100.0 * lineCrossings / pairs << "%"
+                  << ", to another 4 KB page " << 100.0 * pageCrossings / pairs << "%"
+                  << " (" << nodeBytes << "-byte nodes)\n";
+    }
+
+    void PrintSolveStats(const char* name, const BenchStats& stats)
+    {
+        double rate = stats.seconds > 0.0 ? stats.expansions / stats.seconds / 1e6 : 0.0;
+        std::cout << "  " << name
+                  << ": " << stats.seconds * 1000.0 << " ms"
+                  << ", " << rate << " M expansions/s"
+                  << ", expansions " << stats.expansions
+                  << ", total cost " << stats.totalCost << "\n";
+    }
+
+    BenchStats RunGridQueries(Pathfinding& pathfinding, const std::vector<BenchQuery>& queries, const Grid& grid, AlgorithmType algorithm)
+    {
+        SolveOptions options;
+        options.algorithm = algorithm;
+
+        // First query allocates the node pool; keep that out of the timing
+        pathfinding.Solve(0, 0, 0, 0, options);
+
+        BenchStats stats;
+        auto begin = std::chrono::high_resolution_clock::now();
+        for (const BenchQuery& query : queries)
+        {
+            SolveResult result = pathfinding.Solve(query.start / grid.GetDepth(), query.start % grid.GetDepth(),
+                query.goal / grid.GetDepth(), query.goal % grid.GetDepth(), options);
+            stats.expansions += result.nodesExplored;
+            stats.totalCost += result.pathCost;
+        }
+        stats.seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - begin).count();
+        return stats;
+    }
+}
+
+int Benchmark::Run(int argc, char** argv)
+{
+    std::string suite = argc > 0 ? argv[0] : "openlist";
+    int size = GetIntOption(argc, argv, "--size", 1024);
+    int queries = GetIntOption(argc, argv, "--queries", 50);
+    unsigned int seed = static_cast<unsigned int>(GetIntOption(argc, argv, "--seed", 1));
+
+    bool all = suite == "all";
+    bool known = all;
+
+    if (all || suite == "openlist")
+    {
+        RunOpenListBenchmark(size, queries, seed);
+        known = true;
+    }
+
+    if (all || suite == "bucket")
+    {
+        RunBucketQueueBenchmark(size, queries, seed);
+        known = true;
+    }
+
+    if (all || suite == "layout")
+    {
+        RunLayoutBenchmark(size, queries, seed);
+        known = true;
+    }
+
+    // Needs files, so not part of "all"
+    if (suite == "scenario")
+    {
+        return RunScenarioBenchmark(GetStringOption(argc, argv, "--scen", ""), GetStringOption(argc, argv, "--map", ""),
+            GetStringOption(argc, argv, "--algorithm", "astar"), GetStringOption(argc, argv, "--heuristic", "manhattan")) ? 0 : 1;
+    }
+
+    if (!known)
+    {
+        std::cerr << "Unknown benchmark '" << suite << "'. Available: openlist, bucket, layout, scenario, all" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+void Benchmark::RunOpenListBenchmark(int size, int queries, unsigned int seed)
+{
+    std::cout << "Open list benchmark: " << size << "x" << size << ", "
+              << queries << " queries, seed " << seed << "\n";
+
+    // Cells are charged on entry, so only A* lowers queued keys; weights make that frequent
+    const int maxCosts[] = { 1, 9 };
+    for (int maxCost : maxCosts)
+    {
+        BenchGrid grid = MakeGrid(size, maxCost, seed);
+        std::vector<BenchQuery> queryList = MakeQueries(grid, queries, seed);
+
+        for (int heuristic = 0; heuristic < 2; heuristic++)
+        {
+            std::cout << (heuristic ? "A*" : "Dijkstra") << ", cell costs 1-" << maxCost << ":\n";
+            PrintStats("indexed 4-ary heap", RunIndexedHeap(grid, queryList, heuristic != 0));
+            PrintStats("lazy deletion     ", RunLazyDeletion(grid, queryList, heuristic != 0));
+        }
+    }
+}
+
+void Benchmark::RunBucketQueueBenchmark(int size, int queries, unsigned int seed)
+{
+    std::cout << "Bucket queue benchmark: " << size << "x" << size << ", "
+              << queries << " queries, seed " << seed << "\n";
+
+    const int maxCosts[] = { 1, 4, 9 };
+    for (int maxCost : maxCosts)
+    {
+        BenchGrid grid = MakeGrid(size, maxCost, seed);
+        std::vector<BenchQuery> queryList = MakeQueries(grid, queries, seed);
+
+        std::cout << "Dijkstra, cell costs 1-" << maxCost << ":\n";
+        PrintStats("bucket queue (Dial)", RunBucketQueue(grid, queryList, maxCost));
+        PrintStats("indexed 4-ary heap ", RunIndexedHeap(grid, queryList, false));
+    }
+}
+
+void Benchmark::RunLayoutBenchmark(int size, int queries, unsigned int seed)
+{
+    // Layout only matters once the node pool is far larger than the caches
+    size = std::max(size, 2048);
+    std::cout << "Grid layout benchmark: " << queries << " queries, seed " << seed << "\n";
+
+    const int sizes[] = { size, size * 2 };
+    for (int side : sizes)
+    {
+        // Queries are plain x * side + z positions, valid in either layout
+        BenchGrid cells = MakeGrid(side, 1, seed);
+        std::vector<BenchQuery> queryList = MakeQueries(cells, queries, seed);
+
+        const GridLayout layouts[] = { LAYOUT_ROW_MAJOR, LAYOUT_MORTON, LAYOUT_PADDED };
+        for (GridLayout layout : layouts)
+        {
+            Grid grid(side, side, STORAGE_DENSE, layout);
+            for (int x = 0; x < side; x++)
+            {
+                for (int z = 0; z < side; z++)
+                {
+                    if (cells.cost[static_cast<size_t>(x) * side + z] == 0)
+                        grid.SetTile(x, z, OBSTACLE);
+                }
+            }
+
+            std::cout << side << "x" << side << ", " << GetLayoutName(layout) << " layout:\n";
+            PrintLayoutLocality(grid);
+
+            Pathfinding pathfinding(&grid);
+            PrintSolveStats("Dijkstra", RunGridQueries(pathfinding, queryList, grid, ALGORITHM_DIJKSTRA));
+            PrintSolveStats("A*      ", RunGridQueries(pathfinding, queryList, grid, ALGORITHM_ASTAR));
+        }
+    }
+}
+
+bool Benchmark::RunScenarioBenchmark(const std::string& scenarioPath, const std::string& mapPath,
+    const std::string& algorithmName, const std::string& heuristicName)
+{
+    std::string error;
+    std::vector<ScenarioEntry> entries;
+    if (scenarioPath.empty() || !MovingAI::LoadScenario(scenarioPath, entries, error))
+    {
+        std::cerr << (scenarioPath.empty() ? std::string("--scen <file.scen> is required") : error) << std::endl;
+        return false;
+    }
+    if (entries.empty())
+    {
+        std::cerr << scenarioPath << ": no queries" << std::endl;
+        return false;
+    }
+
+    std::string map = mapPath.empty() ? ResolveScenarioMap(scenarioPath, entries[0].map) : mapPath;
+    Grid grid(1, 1);
+    auto loadBegin = std::chrono::high_resolution_clock::now();
+    if (!MovingAI::LoadMap(map, grid, error))
+    {
+        std::cerr << error << std::endl;
+        return false;
+    }
+    double loadSeconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - loadBegin).count();
+
+    std::vector<AlgorithmType> algorithms;
+    for (const AlgorithmOption& option : ALGORITHM_OPTIONS)
+    {
+        if (algorithmName == "all" || algorithmName == option.name)
+            algorithms.push_back(option.algorithm);
+    }
+    if (algorithms.empty())
+    {
+        std::cerr << "Unknown algorithm '" << algorithmName << "'. Available:";
+        for (const AlgorithmOption& option : ALGORITHM_OPTIONS)
+            std::cerr << " " << option.name;
+        std::cerr << ", all" << std::endl;
+        return false;
+    }
+
+    std::cout << "Scenario benchmark: " << scenarioPath << ", " << entries.size() << " queries on "
+              << map << " (" << grid.GetWidth() << "x" << grid.GetDepth() << ", loaded in "
+              << loadSeconds * 1000.0 << " ms)\n";
+    if (entries[0].mapWidth != grid.GetWidth() || entries[0].mapHeight != grid.GetDepth())
+        std::cout << "Warning: scenario expects a " << entries[0].mapWidth << "x" << entries[0].mapHeight << " map\n";
+
+    // A scenario run against the wrong map can name cells that are off it or
+    // blocked; those queries are skipped rather than solved
+    std::vector<bool> usable(entries.size());
+    size_t skipped = 0, first = entries.size();
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        const ScenarioEntry& entry = entries[i];
+        usable[i] = grid.IsPassable(entry.startX, entry.startZ) && grid.IsPassable(entry.goalX, entry.goalZ);
+        if (!usable[i])
+            skipped++;
+        else if (first == entries.size())
+            first = i;
+    }
+    if (skipped == entries.size())
+    {
+        std::cerr << scenarioPath << ": no query has both endpoints on open tiles of " << map << std::endl;
+        return false;
+    }
+    const size_t queried = entries.size() - skipped;
+
+    Pathfinding pathfinding(&grid);
+    SolveOptions options;
+    options.heuristic = heuristicName == "landmarks" ? HEURISTIC_LANDMARKS : HEURISTIC_MANHATTAN;
+
+    for (AlgorithmType algorithm : algorithms)
+    {
+        options.algorithm = algorithm;
+        std::cout << Pathfinding::GetAlgorithmName(algorithm)
+                  << (IsEightConnected(algorithm) ? " (8-connected, costs comparable to the published optimum)"
+                                                 : " (4-connected, costs are at least the 8-connected optimum)")
+                  << ":\n";
+
+        // Preprocessing engines build their tables on the first query; do that off the clock
+        pathfinding.Solve(entries[first].startX, entries[first].startZ, entries[first].startX, entries[first].startZ, options);
+
+        long long expansions = 0;
+        double seconds = 0.0, ratioSum = 0.0;
+        int solved = 0, mismatches = 0;
+        for (size_t i = 0; i < entries.size(); i++)
+        {
+            const ScenarioEntry& entry = entries[i];
+            if (!usable[i])
+            {
+                std::cout << "  #" << i << " bucket " << entry.bucket << ": skipped, endpoint off the map or blocked\n";
+                continue;
+            }
+            auto begin = std::chrono::high_resolution_clock::now();
+            SolveResult result = pathfinding.Solve(entry.startX, entry.startZ, entry.goalX, entry.goalZ, options);
+            double elapsed = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - begin).count();
+
+            expansions += result.nodesExplored;
+            seconds += elapsed;
+
+            std::cout << "  #" << i << " bucket " << entry.bucket
+                      << ": expansions " << result.nodesExplored;
+            if (result.found)
+            {
+                double ratio = entry.optimalLength > 0.0 ? result.pathCost / entry.optimalLength : 1.0;
+                solved++;
+                ratioSum += ratio;
+                if (std::abs(result.pathCost - entry.optimalLength) > 1e-3 * std::max(1.0, entry.optimalLength))
+                    mismatches++;
+                std::cout << ", cost " << std::fixed << std::setprecision(4) << result.pathCost
+                          << " (optimal " << entry.optimalLength << ", x" << ratio << ")";
+                std::cout.unsetf(std::ios_base::floatfield);
+                std::cout << std::setprecision(6);
+            }
+            else
+            {
+                mismatches++;
+                std::cout << ", no path (optimal " << entry.optimalLength << ")";
+            }
+            std::cout << ", " << elapsed * 1000.0 << " ms\n";
+        }
+
+        std::cout << "  total: " << solved << "/" << queried << " solved"
+                  << ", " << mismatches << " off the published optimum"
+                  << ", " << skipped << " skipped"
+                  << ", mean cost ratio " << (solved > 0 ? ratioSum / solved : 0.0)
+                  << ", expansions " << expansions
+                  << ", " << seconds * 1000.0 << " ms"
+                  << " (" << seconds * 1000.0 / queried << " ms/query)\n";
+    }
+
+    return true;
+}
+
+int Benchmark::GetIntOption(int argc, char** argv, const char* name, int defaultValue)
+{
+    for (int i = 0; i + 1 < argc; i++)
+    {
+        if (std::strcmp(argv[i], name) == 0)
+            return std::atoi(argv[i + 1]);
+    }
+    return defaultValue;
+}
+
+std::string Benchmark::GetStringOption(int argc, char** argv, const char* name, const char* defaultValue)
+{
+    for (int i = 0; i + 1 < argc; i++)
+    {
+        if (std::strcmp(argv[i], name) == 0)
+            return argv[i + 1];
+    }
+    return defaultValue;
+}
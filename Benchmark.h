@@ -0,0 +1,36 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <string>
+
+// Headless micro-benchmarks for the search engines, run from the command line:
+//   PathfindingVisualizer --benchmark <suite> [--size N] [--queries N] [--seed N]
+// where <suite> is openlist, bucket, layout or all, or for Moving AI scenarios:
+//   PathfindingVisualizer --benchmark scenario --scen file.scen [--map file.map]
+//       [--algorithm dijkstra|astar|dial|jps|jpsplus|bidijkstra|biastar|hpa|all] [--heuristic manhattan|landmarks]
+class Benchmark
+{
+public:
+    // Dispatch on the arguments that follow --benchmark; returns the process exit code
+    static int Run(int argc, char** argv);
+
+    // Indexed decrease-key heap vs. std::priority_queue with lazy-deleted duplicates
+    static void RunOpenListBenchmark(int size, int queries, unsigned int seed);
+
+    // Dijkstra over the bucket queue (Dial) vs. the indexed heap, unit and small integer costs
+    static void RunBucketQueueBenchmark(int size, int queries, unsigned int seed);
+
+    // Row-major vs. Morton vs. padded cell ids for Grid and the node pool, on maps of at least 2048x2048
+    static void RunLayoutBenchmark(int size, int queries, unsigned int seed);
+
+    // Every query of a .scen file: expansions, cost against the published optimum, wall time.
+    // Without --map the map is looked up next to the scenario file.
+    static bool RunScenarioBenchmark(const std::string& scenarioPath, const std::string& mapPath,
+        const std::string& algorithm, const std::string& heuristic);
+
+private:
+    static int GetIntOption(int argc, char** argv, const char* name, int defaultValue);
+    static std::string GetStringOption(int argc, char** argv, const char* name, const char* defaultValue);
+};
+
+#endif
@@ -0,0 +1,248 @@
+#include "BinaryMap.h"
+#include "MappedFile.h"
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+namespace
+{
+    const char MAGIC[8] = { 'P', 'F', 'V', 'M', 'A', 'P', '1', '\0' };
+    const std::uint32_t VERSION = 1;
+    const std::uint32_t FLAG_COST_LAYER = 1;
+
+    struct Header
+    {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t flags;
+        std::int32_t width, depth;
+        std::int32_t startX, startZ;
+        std::int32_t goalX, goalZ;
+        std::uint32_t wordsPerRow;
+        std::uint32_t reserved0;
+        std::uint64_t contentHash;
+        std::uint64_t reserved1;
+    };
+    static_assert(sizeof(Header) == 64, "binary map header must stay 64 bytes");
+
+    bool IsLittleEndian()
+    {
+        const std::uint32_t probe = 1;
+        unsigned char first;
+        std::memcpy(&first, &probe, 1);
+        return first == 1;
+    }
+
+    // FNV-1a over 64-bit words, then the tail bytes; fast enough to check a
+    // large bitboard on every load
+    std::uint64_t HashContent(const char* data, size_t size)
+    {
+        std::uint64_t hash = 0xcbf29ce484222325ull;
+        const std::uint64_t prime = 0x100000001b3ull;
+        size_t i = 0;
+        for (; i + 8 <= size; i += 8)
+        {
+            std::uint64_t word;
+            std::memcpy(&word, data + i, 8);
+            hash = (hash ^ word) * prime;
+        }
+        for (; i < size; i++)
+            hash = (hash ^ static_cast<unsigned char>(data[i])) * prime;
+        return hash;
+    }
+
+    bool ValidPoint(const Header& header, const std::uint64_t* bits, int x, int z)
+    {
+        if (x < 0 || x >= header.width || z < 0 || z >= header.depth)
+            return false;
+        return (bits[static_cast<size_t>(z) * header.wordsPerRow + (x >> 6)] >> (x & 63)) & 1;
+    }
+}
+
+bool BinaryMap::Save(const Grid& grid, const std::string& path, std::string& error)
+{
+    if (!IsLittleEndian())
+    {
+        error = "binary maps are little-endian; this host is not";
+        return false;
+    }
+
+    const int width = grid.GetWidth();
+    const int depth = grid.GetDepth();
+    const int wordsPerRow = grid.GetWordsPerRow();
+
+    // Bitboard then, when any tile is weighted, one cost byte per tile in row order
+    const size_t bitboardBytes = static_cast<size_t>(wordsPerRow) * depth * sizeof(std::uint64_t);
+    const bool hasCosts = !grid.HasUniformCosts();
+    std::vector<char> body(bitboardBytes + (hasCosts ? static_cast<size_t>(width) * depth : 0));
+    for (int z = 0; z < depth; z++)
+    {
+        for (int word = 0; word < wordsPerRow; word++)
+        {
+            std::uint64_t bits = grid.GetPassableWord(z, word);
+            std::memcpy(&body[(static_cast<size_t>(z) * wordsPerRow + word) * sizeof(std::uint64_t)], &bits, sizeof(bits));
+        }
+    }
+    if (hasCosts)
+    {
+        char* costs = &body[bitboardBytes];
+        for (int z = 0; z < depth; z++)
+            for (int x = 0; x < width; x++)
+                costs[static_cast<size_t>(z) * width + x] = static_cast<char>(grid.GetCost(x, z));
+    }
+
+    Header header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.flags = hasCosts ? FLAG_COST_LAYER : 0;
+    header.width = width;
+    header.depth = depth;
+    header.startX = header.startZ = header.goalX = header.goalZ = -1;
+    if (grid.HasStart())
+    {
+        int x, z;
+        grid.GetStart(x, z);
+        header.startX = x;
+        header.startZ = z;
+    }
+    if (grid.HasGoal())
+    {
+        int x, z;
+        grid.GetGoal(x, z);
+        header.goalX = x;
+        header.goalZ = z;
+    }
+    header.wordsPerRow = static_cast<std::uint32_t>(wordsPerRow);
+    header.contentHash = HashContent(body.data(), body.size());
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out)
+    {
+        error = "cannot write " + path;
+        return false;
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(body.data(), body.size());
+    if (!out)
+    {
+        error = path + ": write failed";
+        return false;
+    }
+    return true;
+}
+
+bool BinaryMap::Load(const std::string& path, Grid& grid, std::string& error, bool verify)
+{
+    if (!IsLittleEndian())
+    {
+        error = "binary maps are little-endian; this host is not";
+        return false;
+    }
+
+    std::shared_ptr<MappedFile> file = std::make_shared<MappedFile>();
+    if (!file->Open(path))
+    {
+        error = "cannot open " + path;
+        return false;
+    }
+
+    if (file->GetSize() < sizeof(Header))
+    {
+        error = path + ": too short for a map header";
+        return false;
+    }
+
+    Header header;
+    std::memcpy(&header, file->GetData(), sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0)
+    {
+        error = path + ": not a binary map";
+        return false;
+    }
+    if (header.version != VERSION)
+    {
+        error = path + ": unsupported version " + std::to_string(header.version);
+        return false;
+    }
+    if (header.width <= 0 || header.depth <= 0 ||
+        header.wordsPerRow != static_cast<std::uint32_t>((header.width + 63) / 64))
+    {
+        error = path + ": bad dimensions";
+        return false;
+    }
+
+    const std::uint64_t bitboardBytes = static_cast<std::uint64_t>(header.wordsPerRow) * header.depth * sizeof(std::uint64_t);
+    const std::uint64_t costBytes = (header.flags & FLAG_COST_LAYER)
+        ? static_cast<std::uint64_t>(header.width) * header.depth : 0;
+    if (file->GetSize() != sizeof(Header) + bitboardBytes + costBytes)
+    {
+        error = path + ": size does not match the header";
+        return false;
+    }
+
+    const char* body = file->GetData() + sizeof(Header);
+    if (verify && HashContent(body, static_cast<size_t>(bitboardBytes + costBytes)) != header.contentHash)
+    {
+        error = path + ": content hash mismatch";
+        return false;
+    }
+
+    // Mappings are page-aligned and the header is 64 bytes, so the words are aligned
+    const std::uint64_t* bits = reinterpret_cast<const std::uint64_t*>(body);
+
+    // Word scans rely on clear padding bits; one word per row to check
+    int tailBits = header.width & 63;
+    if (tailBits)
+    {
+        std::uint64_t padding = ~((std::uint64_t(1) << tailBits) - 1);
+        for (int z = 0; z < header.depth; z++)
+        {
+            if (bits[static_cast<size_t>(z) * header.wordsPerRow + header.wordsPerRow - 1] & padding)
+            {
+                error = path + ": padding bits set in row " + std::to_string(z);
+                return false;
+            }
+        }
+    }
+
+    bool hasStart = header.startX != -1 || header.startZ != -1;
+    bool hasGoal = header.goalX != -1 || header.goalZ != -1;
+    if ((hasStart && !ValidPoint(header, bits, header.startX, header.startZ)) ||
+        (hasGoal && !ValidPoint(header, bits, header.goalX, header.goalZ)))
+    {
+        error = path + ": start or goal is outside the map or blocked";
+        return false;
+    }
+
+    grid.BeginBatch();
+    if (!grid.AttachPassability(file, bits, header.width, header.depth))
+    {
+        grid.Resize(header.width, header.depth);
+        for (int z = 0; z < header.depth; z++)
+            for (int x = 0; x < header.width; x++)
+                if (!((bits[static_cast<size_t>(z) * header.wordsPerRow + (x >> 6)] >> (x & 63)) & 1))
+                    grid.SetTile(x, z, OBSTACLE);
+    }
+    if (hasStart)
+        grid.SetStart(header.startX, header.startZ);
+    if (hasGoal)
+        grid.SetGoal(header.goalX, header.goalZ);
+
+    // Costs are copied; the grid keeps them in its own sparse layer
+    if (header.flags & FLAG_COST_LAYER)
+    {
+        const unsigned char* costs = reinterpret_cast<const unsigned char*>(body + bitboardBytes);
+        for (int z = 0; z < header.depth; z++)
+        {
+            for (int x = 0; x < header.width; x++)
+            {
+                unsigned char cost = costs[static_cast<size_t>(z) * header.width + x];
+                if (cost != 1)
+                    grid.SetCost(x, z, cost);
+            }
+        }
+    }
+    grid.EndBatch();
+    return true;
+}
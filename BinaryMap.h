@@ -0,0 +1,38 @@
+#ifndef BINARYMAP_H
+#define BINARYMAP_H
+
+#include <string>
+#include "Grid.h"
+
+// Native map format, built to be mapped and used in place.
+//
+//   offset  size  field
+//        0     8  magic "PFVMAP1\0"
+//        8     4  version (1)
+//       12     4  flags (bit 0: cost layer follows the bitboard)
+//       16     8  width, depth
+//       24    16  startX, startZ, goalX, goalZ (-1 when unset)
+//       40     4  words per bitboard row, (width + 63) / 64
+//       44     4  reserved, zero
+//       48     8  content hash of everything after the header
+//       56     8  reserved, zero
+//       64        passability bitboard: depth rows of words, bit x of a row set
+//                 when the cell is walkable, padding bits clear (Grid's layout)
+//                 optional cost layer: width * depth bytes, row-major
+//
+// All fields are little-endian. The bitboard starts 64 bytes into a page-aligned
+// mapping, so a dense Grid reads it directly without a copy.
+class BinaryMap
+{
+public:
+    // Writes passability and start/goal, and the cost layer if any tile is weighted
+    static bool Save(const Grid& grid, const std::string& path, std::string& error);
+
+    // Dense grids attach to the mapped file and copy nothing until edited;
+    // chunked grids are filled from it. Observers see a single change.
+    // With verify set, the content hash is checked before the grid is touched.
+    // A cost layer is copied into the grid's costs.
+    static bool Load(const std::string& path, Grid& grid, std::string& error, bool verify = true);
+};
+
+#endif
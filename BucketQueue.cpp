@@ -0,0 +1,54 @@
+#include "BucketQueue.h"
+
+BucketQueue::BucketQueue()
+    : currentKey(-1)
+    , count(0)
+{
+    Reset(1);
+}
+
+void BucketQueue::Reset(int maxEdgeCost)
+{
+    size_t bucketCount = static_cast<size_t>(maxEdgeCost < 1 ? 1 : maxEdgeCost) + 1;
+    if (buckets.size() != bucketCount)
+        buckets.assign(bucketCount, std::vector<CellId>());
+
+    Clear();
+}
+
+void BucketQueue::Clear()
+{
+    // Keep bucket capacity around for the next search
+    for (std::vector<CellId>& bucket : buckets)
+        bucket.clear();
+
+    currentKey = -1;
+    count = 0;
+}
+
+void BucketQueue::Push(CellId cell, int key)
+{
+    // The first push after a clear may start anywhere; later keys are relative to the last pop
+    if (currentKey < 0)
+        currentKey = key;
+
+    buckets[static_cast<size_t>(key) % buckets.size()].push_back(cell);
+    count++;
+}
+
+CellId BucketQueue::Pop()
+{
+    // Advance around the ring to the next non-empty bucket
+    std::vector<CellId>* bucket = &buckets[static_cast<size_t>(currentKey) % buckets.size()];
+    while (bucket->empty())
+    {
+        currentKey++;
+        bucket = &buckets[static_cast<size_t>(currentKey) % buckets.size()];
+    }
+
+    CellId cell = bucket->back();
+    bucket->pop_back();
+    count--;
+
+    return cell;
+}
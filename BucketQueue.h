@@ -0,0 +1,36 @@
+#ifndef BUCKETQUEUE_H
+#define BUCKETQUEUE_H
+
+#include <vector>
+#include <cstddef>
+#include "Grid.h"
+
+// Monotone bucket queue (Dial's algorithm) for small non-negative integer keys.
+// Keys pushed while the minimum is k must lie in [k, k + maxEdgeCost], so a ring
+// of maxEdgeCost + 1 buckets covers every live key and push/pop are O(1).
+// Decrease-key is a second push; the caller skips the stale entry when it pops.
+class BucketQueue
+{
+public:
+    BucketQueue();
+
+    // Size the ring for the largest edge cost and empty the queue
+    void Reset(int maxEdgeCost);
+    void Clear();
+
+    bool Empty() const { return count == 0; }
+    size_t Size() const { return count; }
+
+    void Push(CellId cell, int key);
+    CellId Pop();
+
+    // Key of the bucket the last Pop() came from
+    int GetCurrentKey() const { return currentKey; }
+
+private:
+    std::vector<std::vector<CellId>> buckets;
+    int currentKey;
+    size_t count;
+};
+
+#endif
@@ -0,0 +1,85 @@
+#include "DirtyTracker.h"
+#include <algorithm>
+
+DirtyTracker::DirtyTracker(const Grid* grid, DirtyKind kind)
+    : grid(grid)
+    , kind(kind)
+    , seen(0)
+{
+}
+
+bool DirtyTracker::IsDirty() const
+{
+    std::uint64_t latest = kind == DIRTY_PASSABILITY ? grid->GetPassabilityVersion() : grid->GetVersion();
+    return latest > seen;
+}
+
+void DirtyTracker::GetDirtyRects(std::vector<DirtyRect>& rects) const
+{
+    rects.clear();
+    if (!IsDirty())
+        return;
+
+    const int width = grid->GetWidth();
+    const int depth = grid->GetDepth();
+    if (IsAllDirty())
+    {
+        if (width > 0 && depth > 0)
+            rects.push_back({ 0, 0, width - 1, depth - 1 });
+        return;
+    }
+
+    // Recent writes are in the change log, newest first, with exact bounds
+    const bool passability = kind == DIRTY_PASSABILITY;
+    if (seen >= grid->GetChangeLogFloor())
+    {
+        for (int age = 0; age < grid->GetChangeLogCount(); age++)
+        {
+            const Grid::ChangeRecord& record = grid->GetChangeRecord(age);
+            if (record.version <= seen)
+                break;
+            if (passability && !record.passability)
+                continue;
+            rects.push_back({ record.minX, record.minZ, record.maxX, record.maxZ });
+        }
+        return;
+    }
+
+    // Column stamps let untouched strips of chunks be skipped with one read
+    for (int chunkX = 0; chunkX < grid->GetChunksX(); chunkX++)
+    {
+        if (grid->GetChunkColumnStamp(chunkX, passability) <= seen)
+            continue;
+
+        for (int chunkZ = 0; chunkZ < grid->GetChunksZ(); chunkZ++)
+        {
+            if (grid->GetChunkStamp(chunkX, chunkZ, passability) <= seen)
+                continue;
+
+            DirtyRect rect;
+            rect.minX = chunkX * Grid::CHUNK_SIZE;
+            rect.minZ = chunkZ * Grid::CHUNK_SIZE;
+            rect.maxX = std::min(width, rect.minX + Grid::CHUNK_SIZE) - 1;
+            rect.maxZ = std::min(depth, rect.minZ + Grid::CHUNK_SIZE) - 1;
+            rects.push_back(rect);
+        }
+    }
+}
+
+bool DirtyTracker::GetDirtyBounds(DirtyRect& bounds) const
+{
+    std::vector<DirtyRect> rects;
+    GetDirtyRects(rects);
+    if (rects.empty())
+        return false;
+
+    bounds = rects[0];
+    for (const DirtyRect& rect : rects)
+    {
+        bounds.minX = std::min(bounds.minX, rect.minX);
+        bounds.minZ = std::min(bounds.minZ, rect.minZ);
+        bounds.maxX = std::max(bounds.maxX, rect.maxX);
+        bounds.maxZ = std::max(bounds.maxZ, rect.maxZ);
+    }
+    return true;
+}
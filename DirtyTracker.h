@@ -0,0 +1,52 @@
+#ifndef DIRTYTRACKER_H
+#define DIRTYTRACKER_H
+
+#include <cstdint>
+#include <vector>
+#include "Grid.h"
+
+// Which edits make a region dirty
+enum DirtyKind {
+    DIRTY_TILES,        // Any tile state change, START and GOAL included
+    DIRTY_PASSABILITY   // Only cells switching between walkable and OBSTACLE
+};
+
+// Inclusive rectangle in grid coordinates
+struct DirtyRect
+{
+    int minX, minZ, maxX, maxZ;
+};
+
+// One consumer's view of what changed on a grid since it last caught up.
+// Trackers only remember a version, so any number of them can follow one
+// grid, each clearing on its own schedule, at no cost to the grid's writes.
+// Regions are the exact bounds of recent writes, or whole chunks
+// (Grid::CHUNK_SIZE cells on a side) for a tracker that fell further behind
+// than the grid's change log reaches.
+class DirtyTracker
+{
+public:
+    // Starts with everything dirty, so the first update is a full one
+    DirtyTracker(const Grid* grid, DirtyKind kind = DIRTY_TILES);
+
+    bool IsDirty() const;
+    // A whole-grid change (clear, resize, load) happened; regions do not apply
+    bool IsAllDirty() const { return grid->GetResetVersion() > seen; }
+
+    // Rectangles covering every change, clipped to the grid; the whole grid if IsAllDirty.
+    // They may overlap.
+    void GetDirtyRects(std::vector<DirtyRect>& rects) const;
+    // Bounding box of every dirty rectangle; false when nothing is dirty
+    bool GetDirtyBounds(DirtyRect& bounds) const;
+
+    // Everything up to now has been handled
+    void Clear() { seen = grid->GetVersion(); }
+    void MarkAllDirty() { seen = 0; }
+
+private:
+    const Grid* grid;
+    DirtyKind kind;
+    std::uint64_t seen;     // Grid version this consumer is up to date with
+};
+
+#endif
@@ -0,0 +1,233 @@
+#include "EditJournal.h"
+
+EditJournal::EditJournal(Grid* grid, size_t memoryBudget)
+    : grid(grid)
+    , memoryBudget(memoryBudget)
+    , memoryUsage(0)
+    , actionDepth(0)
+    , capturing(false)
+    , applying(false)
+    , batchAction(false)
+    , overflowed(false)
+    , width(grid->GetWidth())
+    , depth(grid->GetDepth())
+{
+    grid->AddObserver(this);
+}
+
+EditJournal::~EditJournal()
+{
+    grid->RemoveObserver(this);
+}
+
+void EditJournal::BeginAction()
+{
+    actionDepth++;
+}
+
+void EditJournal::EndAction()
+{
+    if (actionDepth == 0 || --actionDepth > 0)
+        return;
+    overflowed = false;
+    if (pending.HasEdits())
+        Push(pending);
+}
+
+void EditJournal::OnBatchBegin()
+{
+    if (applying || capturing)
+        return;
+    batchAction = true;
+    BeginAction();
+}
+
+void EditJournal::OnBatchEnd()
+{
+    if (!batchAction)
+        return;
+    batchAction = false;
+    EndAction();
+}
+
+void EditJournal::BeginSnapshot()
+{
+    // Diffs recorded so far in an open action keep their own step
+    if (pending.HasEdits())
+        Push(pending);
+    capturing = true;
+    pending.before.Capture(*grid);
+}
+
+void EditJournal::EndSnapshot()
+{
+    if (!capturing)
+        return;
+    capturing = false;
+    pending.after.Capture(*grid);
+    width = grid->GetWidth();
+    depth = grid->GetDepth();
+    Push(pending);
+}
+
+bool EditJournal::AcceptEdit()
+{
+    if (applying || capturing || overflowed)
+        return false;
+
+    // Without the early part of an action the rest cannot be undone either,
+    // and older steps no longer line up with the grid, so drop everything
+    if ((pending.edits.size() + 1) * sizeof(TileEdit) + pending.costEdits.size() * sizeof(CostEdit) > memoryBudget)
+    {
+        Clear();
+        overflowed = actionDepth > 0;
+        return false;
+    }
+    return true;
+}
+
+void EditJournal::OnTileChanged(int x, int z, TileState oldState, TileState newState)
+{
+    if (!AcceptEdit())
+        return;
+
+    TileEdit edit = { x, z, oldState, newState };
+    pending.edits.push_back(edit);
+    if (actionDepth == 0)
+        Push(pending);
+}
+
+void EditJournal::OnCostChanged(int x, int z, unsigned char oldCost, unsigned char newCost)
+{
+    if (!AcceptEdit())
+        return;
+
+    CostEdit edit = { x, z, oldCost, newCost };
+    pending.costEdits.push_back(edit);
+    if (actionDepth == 0)
+        Push(pending);
+}
+
+void EditJournal::OnPassabilityChanged(int, int, int, int)
+{
+    if (applying || capturing)
+        return;
+
+    // Recorded diffs cannot be replayed on a grid resized behind our back
+    if (grid->GetWidth() != width || grid->GetDepth() != depth)
+    {
+        Clear();
+        width = grid->GetWidth();
+        depth = grid->GetDepth();
+    }
+}
+
+void EditJournal::Push(Step& step)
+{
+    for (const Step& undone : redoSteps)
+        memoryUsage -= undone.GetMemoryUsage();
+    redoSteps.clear();
+
+    step.edits.shrink_to_fit();
+    step.costEdits.shrink_to_fit();
+    memoryUsage += step.GetMemoryUsage();
+    undoSteps.push_back(std::move(step));
+    step = Step();
+    Trim();
+}
+
+void EditJournal::Trim()
+{
+    // The newest step always survives, however large
+    while (memoryUsage > memoryBudget && undoSteps.size() > 1)
+    {
+        memoryUsage -= undoSteps.front().GetMemoryUsage();
+        undoSteps.pop_front();
+    }
+}
+
+void EditJournal::ApplyEdit(int x, int z, TileState state)
+{
+    // START and GOAL go through the grid's own bookkeeping, so the recorded
+    // start/goal moves replay as moves
+    TileState current = grid->GetTile(x, z);
+    if (current == START && state != START)
+        grid->ClearStart();
+    if (current == GOAL && state != GOAL)
+        grid->ClearGoal();
+
+    if (state == START)
+        grid->SetStart(x, z);
+    else if (state == GOAL)
+        grid->SetGoal(x, z);
+    else
+        grid->SetTile(x, z, state);
+}
+
+bool EditJournal::Undo()
+{
+    if (undoSteps.empty() || actionDepth > 0 || capturing)
+        return false;
+
+    Step step = std::move(undoSteps.back());
+    undoSteps.pop_back();
+
+    applying = true;
+    grid->BeginBatch();
+    if (step.IsSnapshot())
+    {
+        step.before.Restore(*grid);
+    }
+    else
+    {
+        for (auto edit = step.edits.rbegin(); edit != step.edits.rend(); ++edit)
+            ApplyEdit(edit->x, edit->z, edit->oldState);
+        for (auto edit = step.costEdits.rbegin(); edit != step.costEdits.rend(); ++edit)
+            grid->SetCost(edit->x, edit->z, edit->oldCost);
+    }
+    grid->EndBatch();
+    applying = false;
+
+    width = grid->GetWidth();
+    depth = grid->GetDepth();
+    redoSteps.push_back(std::move(step));
+    return true;
+}
+
+bool EditJournal::Redo()
+{
+    if (redoSteps.empty() || actionDepth > 0 || capturing)
+        return false;
+
+    Step step = std::move(redoSteps.back());
+    redoSteps.pop_back();
+
+    applying = true;
+    grid->BeginBatch();
+    if (step.IsSnapshot())
+    {
+        step.after.Restore(*grid);
+    }
+    else
+    {
+        for (const TileEdit& edit : step.edits)
+            ApplyEdit(edit.x, edit.z, edit.newState);
+        for (const CostEdit& edit : step.costEdits)
+            grid->SetCost(edit.x, edit.z, edit.newCost);
+    }
+    grid->EndBatch();
+    applying = false;
+
+    width = grid->GetWidth();
+    depth = grid->GetDepth();
+    undoSteps.push_back(std::move(step));
+    return true;
+}
+
+void EditJournal::Clear()
+{
+    undoSteps.clear();
+    redoSteps.clear();
+    pending = Step();
+    memoryUsage = 0;
+}
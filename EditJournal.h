@@ -0,0 +1,100 @@
+#ifndef EDITJOURNAL_H
+#define EDITJOURNAL_H
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include "Grid.h"
+#include "RunLength.h"
+
+// Undo/redo history for a grid. Tile and cost writes between BeginAction and
+// EndAction, or inside one grid batch, are recorded as (cell, old, new) diffs
+// and undone as one step, in time proportional to the number of cells
+// touched. Whole-map operations (clear, load) are recorded as compressed
+// snapshots instead. The oldest steps are dropped once the history outgrows
+// its memory budget; a single action larger than the budget clears it.
+class EditJournal : public GridObserver
+{
+public:
+    static const size_t DEFAULT_BUDGET = 64 * 1024 * 1024;
+
+    explicit EditJournal(Grid* grid, size_t memoryBudget = DEFAULT_BUDGET);
+    ~EditJournal();
+
+    // Groups the tile writes of one user action, such as a click or a drag.
+    // Writes outside an action become single-write steps of their own.
+    void BeginAction();
+    void EndAction();
+    bool InAction() const { return actionDepth > 0; }
+
+    // Brackets an operation that rewrites the whole map: the map is captured
+    // before and after, and its individual writes are not recorded.
+    void BeginSnapshot();
+    void EndSnapshot();
+
+    bool CanUndo() const { return !undoSteps.empty(); }
+    bool CanRedo() const { return !redoSteps.empty(); }
+    bool Undo();
+    bool Redo();
+    void Clear();
+
+    size_t GetMemoryUsage() const { return memoryUsage; }
+    size_t GetStepCount() const { return undoSteps.size() + redoSteps.size(); }
+
+    void OnPassabilityChanged(int minX, int minZ, int maxX, int maxZ) override;
+    void OnTileChanged(int x, int z, TileState oldState, TileState newState) override;
+    void OnCostChanged(int x, int z, unsigned char oldCost, unsigned char newCost) override;
+    void OnBatchBegin() override;
+    void OnBatchEnd() override;
+
+private:
+    struct TileEdit
+    {
+        std::int32_t x, z;
+        TileState oldState;
+        TileState newState;
+    };
+
+    // Costs are a separate layer from states, so their diffs replay on their own
+    struct CostEdit
+    {
+        std::int32_t x, z;
+        unsigned char oldCost;
+        unsigned char newCost;
+    };
+
+    struct Step
+    {
+        std::vector<TileEdit> edits;
+        std::vector<CostEdit> costEdits;
+        GridSnapshot before, after;     // Snapshot steps only
+
+        bool IsSnapshot() const { return !before.IsEmpty(); }
+        bool HasEdits() const { return !edits.empty() || !costEdits.empty(); }
+        size_t GetMemoryUsage() const
+        {
+            return sizeof(Step) + edits.capacity() * sizeof(TileEdit) + costEdits.capacity() * sizeof(CostEdit) +
+                before.GetSize() + after.GetSize();
+        }
+    };
+
+    Grid* grid;
+    size_t memoryBudget;
+    size_t memoryUsage;
+    std::deque<Step> undoSteps;     // Oldest first
+    std::vector<Step> redoSteps;    // Most recently undone last
+    Step pending;
+    int actionDepth;
+    bool capturing;     // Inside BeginSnapshot/EndSnapshot
+    bool applying;      // Undo/Redo is writing; nothing is recorded
+    bool batchAction;   // The current action was opened by a grid batch
+    bool overflowed;    // The open action outgrew the budget and is not being recorded
+    int width, depth;   // Dimensions the recorded diffs refer to
+
+    void Push(Step& step);
+    bool AcceptEdit();
+    void ApplyEdit(int x, int z, TileState state);
+    void Trim();
+};
+
+#endif
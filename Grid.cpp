@@ -1,47 +1,666 @@
 #include "Grid.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <utility>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
-Grid::Grid()
-    : hasStart(false)
+static int CountBits(std::uint64_t word)
+{
+#ifdef _MSC_VER
+    return static_cast<int>(__popcnt64(word));
+#else
+    return __builtin_popcountll(word);
+#endif
+}
+
+// All zero, so it is ready before any static Grid is constructed
+Grid::Chunk Grid::emptyChunk = {};
+
+Grid::Grid(int width, int depth, GridStorage storage, GridLayout layout)
+    : width(0)
+    , depth(0)
+    , storage(storage)
+    , layout(layout)
+    , blockShift(0)
+    , blocksZ(1)
+    , cellIdLimit(0)
+    , passableBits(nullptr)
+    , wordsPerRow(0)
+    , lastWordMask(0)
+    , chunksX(0)
+    , chunksZ(0)
+    , allocatedChunks(0)
+    , batchDepth(0)
+    , batchDirty(false)
+    , batchMinX(0), batchMinZ(0), batchMaxX(0), batchMaxZ(0)
+    , tileCounts()
+    , costCounts()
+    , version(0)
+    , resetVersion(0)
+    , passabilityVersion(0)
+    , changeLog(CHANGE_LOG_SIZE)
+    , changeLogNext(0)
+    , changeLogCount(0)
+    , changeLogFloor(0)
+    , hasStart(false)
     , hasGoal(false)
     , startX(-1)
     , startZ(-1)
     , goalX(-1)
     , goalZ(-1)
 {
+    Resize(width, depth);
+}
+
+Grid::~Grid()
+{
+    ReleaseChunks();
+}
+
+void Grid::Resize(int width, int depth)
+{
+    SetDimensions(width, depth);
+
+    ChangeStamp unchanged = {};
+    chunkStamps.assign(static_cast<size_t>(chunksX) * chunksZ, unchanged);
+    columnStamps.assign(static_cast<size_t>(chunksX), unchanged);
+
+    if (storage == STORAGE_CHUNKED)
+    {
+        ReleaseChunks();
+        chunks.assign(static_cast<size_t>(chunksX) * chunksZ, &emptyChunk);
+    }
+    else
+    {
+        mapping.reset();
+        tiles.assign(static_cast<size_t>(cellIdLimit), EMPTY);
+        passable.assign(static_cast<size_t>(wordsPerRow) * depth, 0);
+        passableBits = passable.data();
+    }
+
+    // Rectangles batched before the resize may lie outside the new bounds;
+    // the whole-grid change ClearGrid reports covers them anyway
+    batchDirty = false;
     ClearGrid();
 }
 
+void Grid::SetDimensions(int width, int depth)
+{
+    this->width = width;
+    this->depth = depth;
+    wordsPerRow = (width + 63) / 64;
+    int tailBits = width & 63;
+    lastWordMask = tailBits ? (std::uint64_t(1) << tailBits) - 1 : ~std::uint64_t(0);
+    chunksX = (width + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    chunksZ = (depth + CHUNK_SIZE - 1) / CHUNK_SIZE;
+
+    // Morton blocks cover the shorter side in one block, so long thin maps
+    // become a row of square blocks instead of one mostly unused square
+    blockShift = 0;
+    while ((1 << blockShift) < std::min(width, depth))
+        blockShift++;
+    blocksZ = (depth + (1 << blockShift) - 1) >> blockShift;
+    if (layout == LAYOUT_MORTON)
+        cellIdLimit = width > 0 && depth > 0 ? GetMortonId(width - 1, depth - 1) + 1 : 0;
+    else if (layout == LAYOUT_PADDED)
+        cellIdLimit = static_cast<CellId>(width + 2) * (depth + 2);
+    else
+        cellIdLimit = GetCellCount();
+}
+
+bool Grid::AttachPassability(std::shared_ptr<const MappedFile> file, const std::uint64_t* bits, int width, int depth)
+{
+    if (storage == STORAGE_CHUNKED)
+        return false;
+
+    SetDimensions(width, depth);
+    mapping = file;
+    passableBits = bits;
+
+    ChangeStamp unchanged = {};
+    chunkStamps.assign(static_cast<size_t>(chunksX) * chunksZ, unchanged);
+    columnStamps.assign(static_cast<size_t>(chunksX), unchanged);
+
+    // Owned storage is rebuilt on Detach; free it so only the mapping is resident
+    std::vector<TileState>().swap(tiles);
+    std::vector<std::uint64_t>().swap(passable);
+
+    // Padding bits are clear, so set bits are exactly the walkable cells
+    CellId walkable = 0;
+    for (size_t i = 0, words = static_cast<size_t>(wordsPerRow) * depth; i < words; i++)
+        walkable += CountBits(bits[i]);
+    std::fill(tileCounts, tileCounts + TILE_STATE_COUNT, 0);
+    tileCounts[EMPTY] = walkable;
+    tileCounts[OBSTACLE] = GetCellCount() - walkable;
+    ResetCosts();
+    resetVersion = passabilityVersion = ++version;
+
+    hasStart = false;
+    hasGoal = false;
+    batchDirty = false;
+    NotifyPassabilityChanged(0, 0, width - 1, depth - 1);
+    return true;
+}
+
+void Grid::Detach()
+{
+    passable.assign(passableBits, passableBits + static_cast<size_t>(wordsPerRow) * depth);
+    passableBits = passable.data();
+    mapping.reset();
+
+    tiles.assign(static_cast<size_t>(cellIdLimit), EMPTY);
+    if (layout == LAYOUT_PADDED)
+        FillBorder();
+    for (int z = 0; z < depth; z++)
+        for (int x = 0; x < width; x++)
+            if (!((passableBits[GetWordIndex(x, z)] >> (x & 63)) & 1))
+                tiles[GetCellId(x, z)] = OBSTACLE;
+    if (hasStart)
+        tiles[GetCellId(startX, startZ)] = START;
+    if (hasGoal)
+        tiles[GetCellId(goalX, goalZ)] = GOAL;
+}
+
 TileState Grid::GetTile(int x, int z) const
 {
-    if (x < 0 || x >= SIZE || z < 0 || z >= SIZE)
+    if (!InBounds(x, z))
         return EMPTY;
-    return tiles[x][z];
+    if (storage == STORAGE_CHUNKED)
+        return GetChunk(x, z)->tiles[GetLocalIndex(x, z)];
+    if (mapping)
+    {
+        if (hasStart && x == startX && z == startZ)
+            return START;
+        if (hasGoal && x == goalX && z == goalZ)
+            return GOAL;
+        return IsPassable(x, z) ? EMPTY : OBSTACLE;
+    }
+    return tiles[GetCellId(x, z)];
+}
+
+std::uint64_t Grid::GetPassableWord(int z, int word) const
+{
+    if (z < 0 || z >= depth || word < 0 || word >= wordsPerRow)
+        return 0;
+    if (storage == STORAGE_CHUNKED)
+    {
+        // Chunks are one word wide; columns past the grid edge read as open
+        // in a chunk, so they are masked off here
+        std::uint64_t bits = ~chunks[static_cast<size_t>(word) * chunksZ + z / CHUNK_SIZE]->blocked[z & (CHUNK_SIZE - 1)];
+        return word == wordsPerRow - 1 ? bits & lastWordMask : bits;
+    }
+    return passableBits[static_cast<size_t>(z) * wordsPerRow + word];
 }
 
 void Grid::SetTile(int x, int z, TileState state)
 {
-    if (x < 0 || x >= SIZE || z < 0 || z >= SIZE)
+    if (!InBounds(x, z))
         return;
-    tiles[x][z] = state;
+    WriteTile(x, z, state);
+}
+
+void Grid::WriteTile(int x, int z, TileState state)
+{
+    TileState old = GetTile(x, z);
+    bool wasBlocked = old == OBSTACLE;
+    if (old != state)
+    {
+        tileCounts[old]--;
+        tileCounts[state]++;
+        version++;
+
+        ChangeStamp& chunkStamp = chunkStamps[GetChunkIndex(x, z)];
+        ChangeStamp& columnStamp = columnStamps[x / CHUNK_SIZE];
+        chunkStamp.tiles = columnStamp.tiles = version;
+        bool passabilityChanged = wasBlocked != (state == OBSTACLE);
+        if (passabilityChanged)
+            chunkStamp.passability = columnStamp.passability = passabilityVersion = version;
+        RecordChange(x, z, passabilityChanged);
+
+        NotifyTileChanged(x, z, old, state);
+    }
+
+    if (mapping)
+    {
+        // EMPTY and OBSTACLE come from the bits and START/GOAL from the
+        // coordinates the callers keep, so writes the bits already describe
+        // need no storage of their own
+        bool derived = state == OBSTACLE ? wasBlocked
+            : !wasBlocked && (state == EMPTY || state == START || state == GOAL);
+        if (derived)
+            return;
+        Detach();
+    }
+
+    if (storage == STORAGE_CHUNKED)
+    {
+        WriteChunkTile(x, z, state);
+    }
+    else
+    {
+        tiles[GetCellId(x, z)] = state;
+        if (wasBlocked != (state == OBSTACLE))
+        {
+            std::uint64_t bit = std::uint64_t(1) << (x & 63);
+            if (state == OBSTACLE)
+                passable[GetWordIndex(x, z)] &= ~bit;
+            else
+                passable[GetWordIndex(x, z)] |= bit;
+        }
+    }
+
+    if (wasBlocked != (state == OBSTACLE))
+        NotifyPassabilityChanged(x, z, x, z);
+}
+
+void Grid::WriteChunkTile(int x, int z, TileState state)
+{
+    size_t index = GetChunkIndex(x, z);
+    Chunk* chunk = chunks[index];
+    TileState old = chunk->tiles[GetLocalIndex(x, z)];
+    if (old == state)
+        return;
+
+    // First write into an empty chunk gives it memory of its own
+    if (chunk == &emptyChunk)
+    {
+        chunk = new Chunk(emptyChunk);
+        chunks[index] = chunk;
+        allocatedChunks++;
+    }
+
+    chunk->tiles[GetLocalIndex(x, z)] = state;
+    if (old == EMPTY)
+        chunk->usedCells++;
+    else if (state == EMPTY)
+        chunk->usedCells--;
+
+    std::uint64_t bit = std::uint64_t(1) << (x & 63);
+    if (state == OBSTACLE)
+        chunk->blocked[z & (CHUNK_SIZE - 1)] |= bit;
+    else
+        chunk->blocked[z & (CHUNK_SIZE - 1)] &= ~bit;
+
+    // A chunk that is all EMPTY again is identical to the sentinel
+    if (chunk->usedCells == 0)
+    {
+        delete chunk;
+        chunks[index] = &emptyChunk;
+        allocatedChunks--;
+    }
+}
+
+void Grid::SetCost(int x, int z, unsigned char cost)
+{
+    if (!InBounds(x, z))
+        return;
+    WriteCost(x, z, cost ? cost : 1);
+}
+
+void Grid::WriteCost(int x, int z, unsigned char cost)
+{
+    unsigned char old = GetCost(x, z);
+    if (old == cost)
+        return;
+
+    std::unique_ptr<unsigned char[]>& chunk = costChunks[GetChunkIndex(x, z)];
+    if (!chunk)
+    {
+        chunk.reset(new unsigned char[CHUNK_SIZE * CHUNK_SIZE]);
+        std::fill(chunk.get(), chunk.get() + CHUNK_SIZE * CHUNK_SIZE, 1);
+    }
+    chunk[GetLocalIndex(x, z)] = cost;
+
+    costCounts[old]--;
+    costCounts[cost]++;
+    version++;
+
+    // Costs do not touch passability, so only the tile stamps move
+    chunkStamps[GetChunkIndex(x, z)].tiles = columnStamps[x / CHUNK_SIZE].tiles = version;
+    RecordChange(x, z, false);
+
+    for (GridObserver* observer : observers)
+        observer->OnCostChanged(x, z, old, cost);
+}
+
+void Grid::ResetCosts()
+{
+    costChunks.clear();
+    costChunks.resize(static_cast<size_t>(chunksX) * chunksZ);
+    std::fill(costCounts, costCounts + MAX_COST + 1, 0);
+    costCounts[1] = GetCellCount();
+}
+
+int Grid::GetMaxCost() const
+{
+    int cost = MAX_COST;
+    while (cost > 1 && costCounts[cost] == 0)
+        cost--;
+    return cost;
+}
+
+void Grid::ReleaseChunks()
+{
+    for (Chunk*& chunk : chunks)
+    {
+        if (chunk != &emptyChunk)
+            delete chunk;
+        chunk = &emptyChunk;
+    }
+    allocatedChunks = 0;
 }
 
 void Grid::ClearGrid()
 {
-    for (int x = 0; x < SIZE; x++)
-        for (int z = 0; z < SIZE; z++)
-            tiles[x][z] = EMPTY;
+    if (storage == STORAGE_CHUNKED)
+    {
+        ReleaseChunks();
+    }
+    else
+    {
+        if (mapping)
+        {
+            mapping.reset();
+            tiles.assign(static_cast<size_t>(cellIdLimit), EMPTY);
+            passable.assign(static_cast<size_t>(wordsPerRow) * depth, 0);
+            passableBits = passable.data();
+        }
+        std::fill(tiles.begin(), tiles.end(), EMPTY);
+        FillPassable();
+        if (layout == LAYOUT_PADDED)
+            FillBorder();
+    }
+
+    std::fill(tileCounts, tileCounts + TILE_STATE_COUNT, 0);
+    tileCounts[EMPTY] = GetCellCount();
+    ResetCosts();
+    resetVersion = passabilityVersion = ++version;
 
     hasStart = false;
     hasGoal = false;
+
+    NotifyPassabilityChanged(0, 0, width - 1, depth - 1);
+}
+
+void Grid::FillBorder()
+{
+    // Never reachable through the public API, which works in map coordinates
+    for (int x = -1; x <= width; x++)
+    {
+        tiles[GetCellId(x, -1)] = OBSTACLE;
+        tiles[GetCellId(x, depth)] = OBSTACLE;
+    }
+    for (int z = 0; z < depth; z++)
+    {
+        tiles[GetCellId(-1, z)] = OBSTACLE;
+        tiles[GetCellId(width, z)] = OBSTACLE;
+    }
+}
+
+void Grid::FillPassable()
+{
+    // Every cell walkable; padding bits past the last column stay clear
+    // so word scans never see phantom open cells
+    for (int z = 0; z < depth; z++)
+    {
+        std::uint64_t* row = &passable[static_cast<size_t>(z) * wordsPerRow];
+        std::fill(row, row + wordsPerRow, ~std::uint64_t(0));
+        if (wordsPerRow > 0)
+            row[wordsPerRow - 1] = lastWordMask;
+    }
+}
+
+void Grid::AddObserver(GridObserver* observer) const
+{
+    if (std::find(observers.begin(), observers.end(), observer) == observers.end())
+        observers.push_back(observer);
+}
+
+void Grid::RemoveObserver(GridObserver* observer) const
+{
+    observers.erase(std::remove(observers.begin(), observers.end(), observer), observers.end());
+}
+
+void Grid::BeginBatch()
+{
+    if (batchDepth++ > 0)
+        return;
+
+    for (GridObserver* observer : observers)
+        observer->OnBatchBegin();
+}
+
+void Grid::EndBatch()
+{
+    if (batchDepth == 0 || --batchDepth > 0)
+        return;
+
+    if (batchDirty)
+    {
+        batchDirty = false;
+        NotifyPassabilityChanged(batchMinX, batchMinZ, batchMaxX, batchMaxZ);
+    }
+
+    for (GridObserver* observer : observers)
+        observer->OnBatchEnd();
+}
+
+bool Grid::PaintTile(int x, int z, TilePaint paint)
+{
+    if (!InBounds(x, z))
+        return false;
+    if (paint.cost)
+    {
+        if (GetCost(x, z) == paint.value)
+            return false;
+        WriteCost(x, z, paint.value);
+        return true;
+    }
+    TileState old = GetTile(x, z);
+    if (old == paint.state || old == START || old == GOAL)
+        return false;
+    WriteTile(x, z, paint.state);
+    return true;
+}
+
+CellId Grid::FillRect(int x0, int z0, int x1, int z1, TilePaint paint)
+{
+    int minX = std::max(0, std::min(x0, x1)), maxX = std::min(width - 1, std::max(x0, x1));
+    int minZ = std::max(0, std::min(z0, z1)), maxZ = std::min(depth - 1, std::max(z0, z1));
+
+    CellId changed = 0;
+    BeginBatch();
+    for (int x = minX; x <= maxX; x++)
+        for (int z = minZ; z <= maxZ; z++)
+            changed += PaintTile(x, z, paint);
+    EndBatch();
+    return changed;
+}
+
+CellId Grid::DrawLine(int x0, int z0, int x1, int z1, TilePaint paint)
+{
+    int dx = std::abs(x1 - x0), dz = -std::abs(z1 - z0);
+    int stepX = x0 < x1 ? 1 : -1, stepZ = z0 < z1 ? 1 : -1;
+    int error = dx + dz;
+
+    CellId changed = 0;
+    BeginBatch();
+    while (true)
+    {
+        changed += PaintTile(x0, z0, paint);
+        if (x0 == x1 && z0 == z1)
+            break;
+        int twice = 2 * error;
+        if (twice >= dz)
+        {
+            error += dz;
+            x0 += stepX;
+        }
+        if (twice <= dx)
+        {
+            error += dx;
+            z0 += stepZ;
+        }
+    }
+    EndBatch();
+    return changed;
+}
+
+CellId Grid::FillCircle(int centerX, int centerZ, int radius, TilePaint paint)
+{
+    // r^2 + r rounds the rim outwards, so small radii still look round
+    long long limit = static_cast<long long>(radius) * radius + radius;
+
+    CellId changed = 0;
+    BeginBatch();
+    for (int dz = -radius; dz <= radius; dz++)
+    {
+        int z = centerZ + dz;
+        if (z < 0 || z >= depth)
+            continue;
+        for (int dx = -radius; dx <= radius; dx++)
+        {
+            if (static_cast<long long>(dx) * dx + static_cast<long long>(dz) * dz <= limit)
+                changed += PaintTile(centerX + dx, z, paint);
+        }
+    }
+    EndBatch();
+    return changed;
+}
+
+CellId Grid::FloodFill(int x, int z, TilePaint paint)
+{
+    if (!InBounds(x, z))
+        return 0;
+    TileState target = GetTile(x, z);
+    unsigned char targetCost = GetCost(x, z);
+    if (paint.cost ? !IsPassable(x, z) || targetCost == paint.value
+        : target == paint.state || target == START || target == GOAL)
+        return 0;
+
+    auto matches = [&](int cellX, int cellZ)
+    {
+        if (paint.cost)
+            return IsPassable(cellX, cellZ) && GetCost(cellX, cellZ) == targetCost;
+        return GetTile(cellX, cellZ) == target;
+    };
+
+    // Scanline fill: each popped seed paints its whole run along x and pushes
+    // one seed per run in the rows beside it. Painted cells no longer match
+    // the target, so nothing is visited twice and no visited set is needed.
+    CellId changed = 0;
+    std::vector<std::pair<int, int>> seeds;
+    seeds.push_back(std::make_pair(x, z));
+
+    BeginBatch();
+    while (!seeds.empty())
+    {
+        int seedX = seeds.back().first;
+        int seedZ = seeds.back().second;
+        seeds.pop_back();
+        if (!matches(seedX, seedZ))
+            continue;
+
+        int left = seedX, right = seedX;
+        while (left > 0 && matches(left - 1, seedZ))
+            left--;
+        while (right < width - 1 && matches(right + 1, seedZ))
+            right++;
+
+        for (int cell = left; cell <= right; cell++)
+            changed += PaintTile(cell, seedZ, paint);
+
+        for (int side = -1; side <= 1; side += 2)
+        {
+            int row = seedZ + side;
+            if (row < 0 || row >= depth)
+                continue;
+            bool inRun = false;
+            for (int cell = left; cell <= right; cell++)
+            {
+                bool match = matches(cell, row);
+                if (match && !inRun)
+                    seeds.push_back(std::make_pair(cell, row));
+                inRun = match;
+            }
+        }
+    }
+    EndBatch();
+    return changed;
+}
+
+void Grid::RecordChange(int x, int z, bool passability)
+{
+    // Widen the newest record when this write lands in its chunk; records
+    // from before the last reset have served their purpose
+    if (changeLogCount > 0)
+    {
+        ChangeRecord& last = changeLog[(changeLogNext + CHANGE_LOG_SIZE - 1) % CHANGE_LOG_SIZE];
+        if (last.passability == passability && last.version > resetVersion &&
+            GetChunkIndex(last.minX, last.minZ) == GetChunkIndex(x, z))
+        {
+            last.version = version;
+            last.minX = std::min(last.minX, x); last.minZ = std::min(last.minZ, z);
+            last.maxX = std::max(last.maxX, x); last.maxZ = std::max(last.maxZ, z);
+            return;
+        }
+    }
+
+    // A full ring drops its oldest record
+    if (changeLogCount == CHANGE_LOG_SIZE)
+        changeLogFloor = changeLog[changeLogNext].version;
+    else
+        changeLogCount++;
+    ChangeRecord record = { version, passability, x, z, x, z };
+    changeLog[changeLogNext] = record;
+    changeLogNext = (changeLogNext + 1) % CHANGE_LOG_SIZE;
+}
+
+void Grid::NotifyTileChanged(int x, int z, TileState oldState, TileState newState)
+{
+    for (GridObserver* observer : observers)
+        observer->OnTileChanged(x, z, oldState, newState);
+}
+
+void Grid::NotifyPassabilityChanged(int minX, int minZ, int maxX, int maxZ)
+{
+    if (batchDepth > 0)
+    {
+        if (!batchDirty)
+        {
+            batchMinX = minX; batchMinZ = minZ;
+            batchMaxX = maxX; batchMaxZ = maxZ;
+            batchDirty = true;
+        }
+        else
+        {
+            batchMinX = std::min(batchMinX, minX); batchMinZ = std::min(batchMinZ, minZ);
+            batchMaxX = std::max(batchMaxX, maxX); batchMaxZ = std::max(batchMaxZ, maxZ);
+        }
+        return;
+    }
+
+    for (GridObserver* observer : observers)
+        observer->OnPassabilityChanged(minX, minZ, maxX, maxZ);
 }
 
 glm::vec3 Grid::GetTileColor(int x, int z) const
 {
-    return GetTileColor(GetTile(x, z));
+    return GetTileColor(GetTile(x, z), GetCost(x, z));
 }
 
-glm::vec3 Grid::GetTileColor(TileState state) const
+glm::vec3 Grid::GetTileColor(TileState state, unsigned char cost) const
 {
+    // Square root ramp, so the small costs most maps use are still told apart
+    if (state == EMPTY && cost > 1)
+    {
+        float t = std::sqrt((cost - 1) / static_cast<float>(MAX_COST - 1));
+        return glm::mix(glm::vec3(0.95f, 0.9f, 0.75f), glm::vec3(0.45f, 0.28f, 0.12f), t);  // Sand to brown
+    }
+
     switch (state)
     {
     case EMPTY:    return glm::vec3(0.95f, 0.95f, 0.95f);  // White
@@ -50,16 +669,28 @@ glm::vec3 Grid::GetTileColor(TileState state) const
     case OBSTACLE: return glm::vec3(0.15f, 0.15f, 0.15f);  // Black
     case VISITED:  return glm::vec3(0.4f, 0.6f, 0.9f);     // Blue
     case PATH:     return glm::vec3(1.0f, 0.8f, 0.2f);     // Yellow
+    case SCANNED:  return glm::vec3(0.7f, 0.8f, 0.95f);    // Pale blue
+    case VISITED_REVERSE: return glm::vec3(0.7f, 0.5f, 0.9f);  // Purple
     default:       return glm::vec3(0.95f, 0.95f, 0.95f);
     }
 }
 
 void Grid::SetStart(int x, int z)
 {
+    // Cleared before the new write so a grid detaching from its mapping
+    // mid-call does not restore the old start
     if (hasStart)
-        tiles[startX][startZ] = EMPTY;
+    {
+        WriteTile(startX, startZ, EMPTY);
+        hasStart = false;
+    }
+
+    WriteTile(x, z, START);
+
+    // The start replaces a goal on the same cell
+    if (hasGoal && goalX == x && goalZ == z)
+        hasGoal = false;
 
-    tiles[x][z] = START;
     startX = x;
     startZ = z;
     hasStart = true;
@@ -68,9 +699,16 @@ void Grid::SetStart(int x, int z)
 void Grid::SetGoal(int x, int z)
 {
     if (hasGoal)
-        tiles[goalX][goalZ] = EMPTY;
+    {
+        WriteTile(goalX, goalZ, EMPTY);
+        hasGoal = false;
+    }
+
+    WriteTile(x, z, GOAL);
+
+    if (hasStart && startX == x && startZ == z)
+        hasStart = false;
 
-    tiles[x][z] = GOAL;
     goalX = x;
     goalZ = z;
     hasGoal = true;
@@ -80,7 +718,7 @@ void Grid::ClearStart()
 {
     if (hasStart)
     {
-        tiles[startX][startZ] = EMPTY;
+        WriteTile(startX, startZ, EMPTY);
         hasStart = false;
     }
 }
@@ -89,15 +727,15 @@ void Grid::ClearGoal()
 {
     if (hasGoal)
     {
-        tiles[goalX][goalZ] = EMPTY;
+        WriteTile(goalX, goalZ, EMPTY);
         hasGoal = false;
     }
 }
 
 glm::vec3 Grid::GetTileWorldPosition(int x, int z) const
 {
-    float xPos = (float)x - SIZE / 2.0f + 0.5f;
-    float zPos = (float)z - SIZE / 2.0f + 0.5f;
+    float xPos = (float)x - width / 2.0f + 0.5f;
+    float zPos = (float)z - depth / 2.0f + 0.5f;
     return glm::vec3(xPos, 0.0f, zPos);
 }
 
@@ -3,15 +3,22 @@
 #define GRID_H
 
 #include <glm/glm.hpp>
+#include <vector>
+#include <memory>
+#include <cstdint>
 
-// Tile states
-enum TileState {
+class MappedFile;
+
+// Tile states, one byte each so large maps stay compact
+enum TileState : unsigned char {
     EMPTY,
     START,
     GOAL,
     OBSTACLE,
     VISITED,
-    PATH
+    PATH,
+    SCANNED,            // Passed over by a JPS scan without becoming a jump point
+    VISITED_REVERSE     // Expanded by the goal-side frontier of a bidirectional search
 };
 
 // Edit modes
@@ -19,24 +26,231 @@ enum EditMode {
     MODE_START,
     MODE_GOAL,
     MODE_OBSTACLE,
-    MODE_CLEAR
+    MODE_CLEAR,
+    MODE_COST       // Paints movement cost; tile states are left alone
+};
+
+// How obstacle and clear modes apply to the tiles under the mouse
+enum BrushShape {
+    BRUSH_TILE,     // Every tile dragged over
+    BRUSH_LINE,     // Straight line from press to release
+    BRUSH_RECT,     // Filled rectangle between press and release
+    BRUSH_CIRCLE,   // Disc stamped along the drag
+    BRUSH_FILL      // Flood fill from the clicked tile
+};
+
+// What a bulk edit writes: a tile state, or a movement cost that leaves
+// tile states alone. Converts from TileState, so states can be passed as is.
+struct TilePaint
+{
+    bool cost;
+    TileState state;
+    unsigned char value;    // Cost, 1 to Grid::MAX_COST
+
+    TilePaint(TileState state) : cost(false), state(state), value(1) {}
+
+    static TilePaint Cost(unsigned char value)
+    {
+        TilePaint paint(EMPTY);
+        paint.cost = true;
+        paint.value = value ? value : 1;
+        return paint;
+    }
+};
+
+// Notified when cells switch between walkable and OBSTACLE.
+// The rectangle is inclusive and given in grid coordinates.
+class GridObserver
+{
+public:
+    virtual ~GridObserver() {}
+    virtual void OnPassabilityChanged(int minX, int minZ, int maxX, int maxZ) = 0;
+
+    // Every single-tile write that changes a tile's state, as it happens and
+    // regardless of batching. Whole-grid operations (Resize, ClearGrid,
+    // attaching a mapped file) report only OnPassabilityChanged.
+    virtual void OnTileChanged(int, int, TileState, TileState) {}
+    // Likewise for movement costs. Costs never change passability, so no
+    // OnPassabilityChanged follows; whole-grid resets report only that one.
+    virtual void OnCostChanged(int, int, unsigned char, unsigned char) {}
+
+    // Outermost BeginBatch / EndBatch, so edits made as one operation can be
+    // treated as one (EndBatch calls this after its passability notification)
+    virtual void OnBatchBegin() {}
+    virtual void OnBatchEnd() {}
+};
+
+// Index of a cell in row storage; 64-bit so width * depth cannot overflow
+typedef std::int64_t CellId;
+
+// How tiles are held in memory. Both back the same accessor API.
+enum GridStorage {
+    STORAGE_DENSE,      // One contiguous tile array plus a row-major bitboard
+    STORAGE_CHUNKED     // CHUNK_SIZE^2 chunks allocated on first write; empty chunks share one sentinel
+};
+
+// Order of cell ids, and so of dense tiles and every per-cell array a search keeps
+enum GridLayout {
+    LAYOUT_ROW_MAJOR,   // id = x * depth + z
+    LAYOUT_MORTON,      // Z-order curve inside square power-of-two blocks; blocks x-major
+    LAYOUT_PADDED       // Like row-major, plus a one-cell OBSTACLE border so neighbor ids are fixed offsets
 };
 
 class Grid
 {
 public:
-    static const int SIZE = 30;
+    static const int DEFAULT_SIZE = 30;
+    static const int CHUNK_SIZE = 64;  // One bitboard word per chunk row
+    static const int TILE_STATE_COUNT = VISITED_REVERSE + 1;
+    static const int MAX_COST = 255;
+
+    Grid(int width = DEFAULT_SIZE, int depth = DEFAULT_SIZE, GridStorage storage = STORAGE_DENSE,
+        GridLayout layout = LAYOUT_ROW_MAJOR);
+    ~Grid();
+
+    // Dimensions. Resize reallocates, clears every tile and notifies observers.
+    void Resize(int width, int depth);
+    int GetWidth() const { return width; }
+    int GetDepth() const { return depth; }
+    GridStorage GetStorage() const { return storage; }
+    GridLayout GetLayout() const { return layout; }
+    size_t GetAllocatedChunkCount() const { return allocatedChunks; }
+    CellId GetCellCount() const { return static_cast<CellId>(width) * depth; }
+    bool InBounds(int x, int z) const { return x >= 0 && x < width && z >= 0 && z < depth; }
 
-    Grid();
+    // Cell ids follow the layout. Morton ids can skip values near the far
+    // edges, so size per-cell arrays with GetCellIdLimit, not GetCellCount.
+    CellId GetCellIdLimit() const { return cellIdLimit; }
+    CellId GetCellId(int x, int z) const
+    {
+        if (layout == LAYOUT_MORTON)
+            return GetMortonId(x, z);
+        if (layout == LAYOUT_PADDED)
+            return static_cast<CellId>(x + 1) * (depth + 2) + (z + 1);
+        return static_cast<CellId>(x) * depth + z;
+    }
+    int GetCellX(CellId cell) const
+    {
+        if (layout == LAYOUT_MORTON)
+            return static_cast<int>(((cell >> (2 * blockShift)) / blocksZ) << blockShift) | CompactBits(GetMortonLocal(cell) >> 1);
+        if (layout == LAYOUT_PADDED)
+            return static_cast<int>(cell / (depth + 2)) - 1;
+        return static_cast<int>(cell / depth);
+    }
+    int GetCellZ(CellId cell) const
+    {
+        if (layout == LAYOUT_MORTON)
+            return static_cast<int>(((cell >> (2 * blockShift)) % blocksZ) << blockShift) | CompactBits(GetMortonLocal(cell));
+        if (layout == LAYOUT_PADDED)
+            return static_cast<int>(cell % (depth + 2)) - 1;
+        return static_cast<int>(cell % depth);
+    }
+
+    // Padded layout: the id step for a move of (dx, dz). Any id one step from
+    // a cell, border included, is safe to pass to IsPassableCell.
+    CellId GetCellStep(int dx, int dz) const { return dx * static_cast<CellId>(depth + 2) + dz; }
+    bool IsPassableCell(CellId cell) const
+    {
+        // Border tiles are stored as OBSTACLE, so no bounds test is needed
+        if (layout == LAYOUT_PADDED && storage == STORAGE_DENSE && !mapping)
+            return tiles[cell] != OBSTACLE;
+        return IsPassable(GetCellX(cell), GetCellZ(cell));
+    }
+
+    // Passability bitboard: one bit per cell, set when the cell is not an
+    // OBSTACLE. Rows run along x, each padded to whole 64-bit words, so a
+    // search can test 64 cells of a row with one load. Out of bounds reads as blocked.
+    bool IsPassable(int x, int z) const
+    {
+        if (!InBounds(x, z))
+            return false;
+        if (storage == STORAGE_CHUNKED)
+            return !((GetChunk(x, z)->blocked[z & (CHUNK_SIZE - 1)] >> (x & 63)) & 1);
+        return (passableBits[GetWordIndex(x, z)] >> (x & 63)) & 1;
+    }
+    int GetWordsPerRow() const { return wordsPerRow; }
+    // Bits for cells 64 * word .. 64 * word + 63 of row z; zero outside the grid
+    std::uint64_t GetPassableWord(int z, int word) const;
+
+    // Dense storage only: make a read-only bitboard the grid's contents without
+    // copying it, typically a view into a memory-mapped map file. The grid keeps
+    // the mapping alive. While attached, tiles are derived from the bits and the
+    // start/goal; the first edit that changes passability copies the bits into
+    // owned storage. Resize and ClearGrid detach. False on chunked grids.
+    bool AttachPassability(std::shared_ptr<const MappedFile> file, const std::uint64_t* bits, int width, int depth);
+    bool IsMapped() const { return mapping != nullptr; }
+
+    // Cells currently in each state, maintained by every write rather than
+    // counted, so it costs nothing per frame on any map size
+    CellId GetTileCount(TileState state) const { return tileCounts[state]; }
+    // Bumped by every change to the map's contents or dimensions; a consumer
+    // that saw the same version before can skip its work
+    std::uint64_t GetVersion() const { return version; }
+
+    // Change stamps for dirty tracking (see DirtyTracker). Every tile write
+    // stamps its CHUNK_SIZE^2 chunk, and the chunk's column of chunks, with the
+    // version it produced; whole-grid changes record their version as the reset.
+    // Passability stamps move only when a cell turns walkable or OBSTACLE.
+    int GetChunksX() const { return chunksX; }
+    int GetChunksZ() const { return chunksZ; }
+    std::uint64_t GetResetVersion() const { return resetVersion; }
+    std::uint64_t GetPassabilityVersion() const { return passabilityVersion; }
+    std::uint64_t GetChunkStamp(int chunkX, int chunkZ, bool passability) const
+    {
+        const ChangeStamp& stamp = chunkStamps[static_cast<size_t>(chunkX) * chunksZ + chunkZ];
+        return passability ? stamp.passability : stamp.tiles;
+    }
+    std::uint64_t GetChunkColumnStamp(int chunkX, bool passability) const
+    {
+        return passability ? columnStamps[chunkX].passability : columnStamps[chunkX].tiles;
+    }
+
+    // Exact bounds of recent writes, so trackers that keep up get the cells
+    // that changed rather than whole chunks. Consecutive writes to one chunk
+    // share a record. Only the newest CHANGE_LOG_SIZE records are kept; writes
+    // at or before GetChangeLogFloor() may be missing.
+    struct ChangeRecord
+    {
+        std::uint64_t version;  // Newest write in the record
+        bool passability;       // Every write in it turned a cell walkable or OBSTACLE
+        int minX, minZ, maxX, maxZ;
+    };
+    static const int CHANGE_LOG_SIZE = 1024;
+    int GetChangeLogCount() const { return changeLogCount; }
+    // Age 0 is the newest record; versions fall with age
+    const ChangeRecord& GetChangeRecord(int age) const
+    {
+        return changeLog[(changeLogNext + CHANGE_LOG_SIZE - 1 - age) % CHANGE_LOG_SIZE];
+    }
+    std::uint64_t GetChangeLogFloor() const { return changeLogFloor; }
 
     // Tile operations
     TileState GetTile(int x, int z) const;
     void SetTile(int x, int z, TileState state);
+    // Resets every tile to EMPTY and every cost to 1
     void ClearGrid();
 
-    // Get tile color based on state
+    // Movement cost layer: stepping onto a tile costs its multiplier, 1 to
+    // MAX_COST, independent of the tile's state. Stored as one byte per tile
+    // in CHUNK_SIZE^2 blocks allocated by the first cost other than 1 in
+    // them, so unweighted maps carry no cost memory at all.
+    unsigned char GetCost(int x, int z) const
+    {
+        if (costCounts[1] == GetCellCount() || !InBounds(x, z))
+            return 1;
+        const unsigned char* chunk = costChunks[GetChunkIndex(x, z)].get();
+        return chunk ? chunk[GetLocalIndex(x, z)] : 1;
+    }
+    void SetCost(int x, int z, unsigned char cost);    // 0 is stored as 1
+    CellId GetCostCount(unsigned char cost) const { return costCounts[cost]; }
+    // Every tile costs 1, so searches that assume unit steps are exact
+    bool HasUniformCosts() const { return costCounts[1] == GetCellCount(); }
+    int GetMaxCost() const;
+
+    // Get tile color based on state; EMPTY tiles shade from white to brown
+    // as their cost rises
     glm::vec3 GetTileColor(int x, int z) const;
-    glm::vec3 GetTileColor(TileState state) const;
+    glm::vec3 GetTileColor(TileState state, unsigned char cost = 1) const;
 
     // Start/Goal management
     void SetStart(int x, int z);
@@ -49,12 +263,140 @@ public:
     void GetStart(int& x, int& z) const { x = startX; z = startZ; }
     void GetGoal(int& x, int& z) const { x = goalX; z = goalZ; }
 
+    // Passability change notifications. Subscribing does not change the map,
+    // so read-only users of a shared grid can subscribe too.
+    void AddObserver(GridObserver* observer) const;
+    void RemoveObserver(GridObserver* observer) const;
+
+    // Bulk edits, each applied as one batch: observers see a single change
+    // and a journal records a single step. A state paint is EMPTY or OBSTACLE
+    // and leaves START and GOAL cells alone; a cost paint covers every cell.
+    // Each returns the number of cells changed.
+    CellId FillRect(int x0, int z0, int x1, int z1, TilePaint paint);
+    CellId DrawLine(int x0, int z0, int x1, int z1, TilePaint paint);     // Bresenham, 8-connected
+    CellId FillCircle(int centerX, int centerZ, int radius, TilePaint paint);
+    // Repaints the 4-connected region of cells sharing the state of (x, z),
+    // or for a cost paint the walkable cells sharing its cost
+    CellId FloodFill(int x, int z, TilePaint paint);
+
+    // Edits between BeginBatch and the matching EndBatch are reported as one
+    // change covering all of them, so caches rebuild once instead of per cell.
+    // Batches nest; only the outermost EndBatch notifies.
+    void BeginBatch();
+    void EndBatch();
+
     // World position helpers
     glm::vec3 GetTileWorldPosition(int x, int z) const;
     void GetTileBounds(int x, int z, glm::vec3& min, glm::vec3& max) const;
 
 private:
-    TileState tiles[SIZE][SIZE];
+    int width;
+    int depth;
+    GridStorage storage;
+    GridLayout layout;
+    int blockShift;     // Morton blocks are 2^blockShift cells on a side
+    CellId blocksZ;
+    CellId cellIdLimit;
+    std::vector<TileState> tiles;   // Dense storage: contiguous, indexed by GetCellId, border included
+    std::vector<std::uint64_t> passable;    // Dense storage: row-major bitboard, kept in step with tiles
+    const std::uint64_t* passableBits;      // Dense storage: passable's data, or the attached view
+    std::shared_ptr<const MappedFile> mapping;
+    int wordsPerRow;
+    std::uint64_t lastWordMask;     // Valid bits of the last word in a row
+
+    struct Chunk
+    {
+        TileState tiles[CHUNK_SIZE * CHUNK_SIZE];   // x-major within the chunk
+        std::uint64_t blocked[CHUNK_SIZE];          // One word per row, bit = local x is an OBSTACLE
+        int usedCells;                              // Tiles that are not EMPTY
+    };
+
+    // Chunked storage: every slot points at its own chunk or at the shared empty one
+    static Chunk emptyChunk;
+    std::vector<Chunk*> chunks;
+    int chunksX, chunksZ;   // Chunk grid; laid out for every storage, used by stamps too
+    size_t allocatedChunks;
+
+    Grid(const Grid&) = delete;
+    Grid& operator=(const Grid&) = delete;
+
+    size_t GetChunkIndex(int x, int z) const { return static_cast<size_t>(x / CHUNK_SIZE) * chunksZ + z / CHUNK_SIZE; }
+    const Chunk* GetChunk(int x, int z) const { return chunks[GetChunkIndex(x, z)]; }
+    static int GetLocalIndex(int x, int z) { return (x & (CHUNK_SIZE - 1)) * CHUNK_SIZE + (z & (CHUNK_SIZE - 1)); }
+    void WriteChunkTile(int x, int z, TileState state);
+    void ReleaseChunks();
+    mutable std::vector<GridObserver*> observers;
+    int batchDepth;
+    bool batchDirty;
+    int batchMinX, batchMinZ, batchMaxX, batchMaxZ;
+
+    CellId GetMortonId(int x, int z) const
+    {
+        int mask = (1 << blockShift) - 1;
+        CellId block = static_cast<CellId>(x >> blockShift) * blocksZ + (z >> blockShift);
+        return (block << (2 * blockShift)) | static_cast<CellId>((SpreadBits(x & mask) << 1) | SpreadBits(z & mask));
+    }
+
+    std::uint64_t GetMortonLocal(CellId cell) const
+    {
+        return static_cast<std::uint64_t>(cell) & ((std::uint64_t(1) << (2 * blockShift)) - 1);
+    }
+
+    // Insert a zero bit above every bit of a 32-bit value, and the reverse
+    // (reading every other bit, starting at bit 0)
+    static std::uint64_t SpreadBits(std::uint32_t value)
+    {
+        std::uint64_t v = value;
+        v = (v | (v << 16)) & 0x0000FFFF0000FFFFull;
+        v = (v | (v << 8)) & 0x00FF00FF00FF00FFull;
+        v = (v | (v << 4)) & 0x0F0F0F0F0F0F0F0Full;
+        v = (v | (v << 2)) & 0x3333333333333333ull;
+        v = (v | (v << 1)) & 0x5555555555555555ull;
+        return v;
+    }
+    static int CompactBits(std::uint64_t v)
+    {
+        v &= 0x5555555555555555ull;
+        v = (v | (v >> 1)) & 0x3333333333333333ull;
+        v = (v | (v >> 2)) & 0x0F0F0F0F0F0F0F0Full;
+        v = (v | (v >> 4)) & 0x00FF00FF00FF00FFull;
+        v = (v | (v >> 8)) & 0x0000FFFF0000FFFFull;
+        v = (v | (v >> 16)) & 0x00000000FFFFFFFFull;
+        return static_cast<int>(v);
+    }
+
+    size_t GetWordIndex(int x, int z) const { return static_cast<size_t>(z) * wordsPerRow + (x >> 6); }
+    void SetDimensions(int width, int depth);
+    void Detach();
+    void FillPassable();
+    void FillBorder();
+    void WriteTile(int x, int z, TileState state);
+    bool PaintTile(int x, int z, TilePaint paint);
+    void WriteCost(int x, int z, unsigned char cost);
+    void ResetCosts();
+    void NotifyPassabilityChanged(int minX, int minZ, int maxX, int maxZ);
+    void NotifyTileChanged(int x, int z, TileState oldState, TileState newState);
+
+    CellId tileCounts[TILE_STATE_COUNT];
+
+    // Cost layer: one block per chunk (same indexing), null while all 1
+    std::vector<std::unique_ptr<unsigned char[]>> costChunks;
+    CellId costCounts[MAX_COST + 1];
+    std::uint64_t version;
+
+    struct ChangeStamp
+    {
+        std::uint64_t tiles;
+        std::uint64_t passability;
+    };
+    std::vector<ChangeStamp> chunkStamps;   // One per chunk, x-major like chunks
+    std::vector<ChangeStamp> columnStamps;  // Newest stamp in each column of chunks
+    std::uint64_t resetVersion;
+    std::uint64_t passabilityVersion;
+    std::vector<ChangeRecord> changeLog;    // Ring of CHANGE_LOG_SIZE records
+    int changeLogNext, changeLogCount;
+    std::uint64_t changeLogFloor;
+    void RecordChange(int x, int z, bool passability);
 
     bool hasStart;
     bool hasGoal;
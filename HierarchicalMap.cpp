@@ -0,0 +1,462 @@
+#include "HierarchicalMap.h"
+#include <algorithm>
+#include <cstdlib>
+
+HierarchicalMap::HierarchicalMap(const Grid* grid)
+    : grid(grid)
+    , built(false)
+    , width(0)
+    , depth(0)
+    , clustersX(0)
+    , clustersZ(0)
+    , transitionCount(0)
+    , changes(grid, DIRTY_PASSABILITY)
+    , generation(1)
+{
+}
+
+void HierarchicalMap::Build()
+{
+    width = grid->GetWidth();
+    depth = grid->GetDepth();
+    clustersX = (width + CLUSTER_SIZE - 1) / CLUSTER_SIZE;
+    clustersZ = (depth + CLUSTER_SIZE - 1) / CLUSTER_SIZE;
+    const int clusterCount = clustersX * clustersZ;
+
+    clusters.assign(clusterCount, Cluster());
+    eastBorders.assign(clusterCount, std::vector<CellId>());
+    northBorders.assign(clusterCount, std::vector<CellId>());
+
+    for (int cx = 0; cx < clustersX; cx++)
+    {
+        for (int cz = 0; cz < clustersZ; cz++)
+        {
+            Cluster& cluster = clusters[cx * clustersZ + cz];
+            cluster.minX = cx * CLUSTER_SIZE;
+            cluster.minZ = cz * CLUSTER_SIZE;
+            cluster.maxX = std::min(width, cluster.minX + CLUSTER_SIZE) - 1;
+            cluster.maxZ = std::min(depth, cluster.minZ + CLUSTER_SIZE) - 1;
+        }
+    }
+
+    for (int cx = 0; cx < clustersX; cx++)
+    {
+        for (int cz = 0; cz < clustersZ; cz++)
+        {
+            BuildBorder(cx, cz, true);
+            BuildBorder(cx, cz, false);
+        }
+    }
+
+    for (int i = 0; i < clusterCount; i++)
+        BuildCluster(i);
+    NumberNodes();
+
+    built = true;
+    changes.Clear();
+}
+
+void HierarchicalMap::Refresh()
+{
+    if (!built || changes.IsAllDirty() || grid->GetWidth() != width || grid->GetDepth() != depth)
+    {
+        Build();
+        return;
+    }
+    if (!changes.IsDirty())
+        return;
+
+    std::vector<DirtyRect> rects;
+    changes.GetDirtyRects(rects);
+    changes.Clear();
+
+    // Clusters overlapping several dirty rects are handled once
+    std::vector<char> touched(clusters.size(), 0);
+    for (const DirtyRect& rect : rects)
+        for (int cx = rect.minX / CLUSTER_SIZE; cx <= rect.maxX / CLUSTER_SIZE; cx++)
+            for (int cz = rect.minZ / CLUSTER_SIZE; cz <= rect.maxZ / CLUSTER_SIZE; cz++)
+                touched[cx * clustersZ + cz] = 1;
+
+    // Rebuild the borders around every touched cluster; a neighbor only needs its
+    // own costs redone when the transitions on a shared border actually moved.
+    std::vector<char> dirty(clusters.size(), 0);
+    for (int cx = 0; cx < clustersX; cx++)
+    {
+        for (int cz = 0; cz < clustersZ; cz++)
+        {
+            if (!touched[cx * clustersZ + cz])
+                continue;
+            dirty[cx * clustersZ + cz] = 1;
+
+            if (BuildBorder(cx, cz, true))
+                dirty[(cx + 1) * clustersZ + cz] = 1;
+            if (BuildBorder(cx, cz, false))
+                dirty[cx * clustersZ + cz + 1] = 1;
+            if (cx > 0 && BuildBorder(cx - 1, cz, true))
+                dirty[(cx - 1) * clustersZ + cz] = 1;
+            if (cz > 0 && BuildBorder(cx, cz - 1, false))
+                dirty[cx * clustersZ + cz - 1] = 1;
+        }
+    }
+
+    for (size_t i = 0; i < clusters.size(); i++)
+    {
+        if (dirty[i])
+            BuildCluster(static_cast<int>(i));
+    }
+    NumberNodes();
+}
+
+void HierarchicalMap::NumberNodes()
+{
+    transitionCount = 0;
+    for (Cluster& cluster : clusters)
+    {
+        cluster.firstNode = transitionCount;
+        transitionCount += static_cast<int>(cluster.transitions.size());
+    }
+
+    // Stale nodes keep older generations, so the pool needs no reset
+    nodes.resize(static_cast<size_t>(transitionCount) + 2);
+}
+
+bool HierarchicalMap::IsWalkable(int x, int z) const
+{
+    return grid->IsPassable(x, z);
+}
+
+int HierarchicalMap::FindTransition(const Cluster& cluster, CellId cell) const
+{
+    // A cluster has a handful of transitions, so a linear scan beats any index
+    for (size_t i = 0; i < cluster.transitions.size(); i++)
+    {
+        if (cluster.transitions[i] == cell)
+            return static_cast<int>(i);
+    }
+    return -1;
+}
+
+bool HierarchicalMap::BuildBorder(int clusterX, int clusterZ, bool east)
+{
+    int clusterIndex = clusterX * clustersZ + clusterZ;
+    std::vector<CellId>& border = east ? eastBorders[clusterIndex] : northBorders[clusterIndex];
+
+    // The last row or column of clusters has nothing beyond it
+    if (east ? clusterX + 1 >= clustersX : clusterZ + 1 >= clustersZ)
+        return false;
+
+    const Cluster& cluster = clusters[clusterIndex];
+    int edge = east ? cluster.maxX : cluster.maxZ;
+    int first = east ? cluster.minZ : cluster.minX;
+    int last = east ? cluster.maxZ : cluster.maxX;
+
+    std::vector<CellId> transitions;
+    int runStart = -1;
+    for (int i = first; i <= last + 1; i++)
+    {
+        bool open = false;
+        if (i <= last)
+            open = east ? (IsWalkable(edge, i) && IsWalkable(edge + 1, i)) : (IsWalkable(i, edge) && IsWalkable(i, edge + 1));
+
+        if (open && runStart < 0)
+        {
+            runStart = i;
+        }
+        else if (!open && runStart >= 0)
+        {
+            // Each maximal opening becomes one transition, or two for wide ones
+            int runEnd = i - 1;
+            if (runEnd - runStart + 1 < MAX_ENTRANCE_WIDTH)
+            {
+                int middle = (runStart + runEnd) / 2;
+                transitions.push_back(east ? grid->GetCellId(edge, middle) : grid->GetCellId(middle, edge));
+            }
+            else
+            {
+                transitions.push_back(east ? grid->GetCellId(edge, runStart) : grid->GetCellId(runStart, edge));
+                transitions.push_back(east ? grid->GetCellId(edge, runEnd) : grid->GetCellId(runEnd, edge));
+            }
+            runStart = -1;
+        }
+    }
+
+    if (transitions == border)
+        return false;
+
+    border.swap(transitions);
+    return true;
+}
+
+void HierarchicalMap::BuildCluster(int clusterIndex)
+{
+    Cluster& cluster = clusters[clusterIndex];
+    int cx = clusterIndex / clustersZ;
+    int cz = clusterIndex % clustersZ;
+
+    // Own side of the +X and +Z borders, plus the far side of the -X and -Z ones
+    cluster.transitions.clear();
+    for (CellId cell : eastBorders[clusterIndex])
+        cluster.transitions.push_back(cell);
+    for (CellId cell : northBorders[clusterIndex])
+        cluster.transitions.push_back(cell);
+    if (cx > 0)
+    {
+        for (CellId cell : eastBorders[clusterIndex - clustersZ])
+            cluster.transitions.push_back(grid->GetCellId(grid->GetCellX(cell) + 1, grid->GetCellZ(cell)));
+    }
+    if (cz > 0)
+    {
+        for (CellId cell : northBorders[clusterIndex - 1])
+            cluster.transitions.push_back(grid->GetCellId(grid->GetCellX(cell), grid->GetCellZ(cell) + 1));
+    }
+
+    // Corner cells can sit on two borders at once
+    std::sort(cluster.transitions.begin(), cluster.transitions.end());
+    cluster.transitions.erase(std::unique(cluster.transitions.begin(), cluster.transitions.end()), cluster.transitions.end());
+
+    const int count = static_cast<int>(cluster.transitions.size());
+    cluster.distances.assign(static_cast<size_t>(count) * count, -1);
+
+    for (int i = 0; i < count; i++)
+    {
+        SearchCluster(cluster, grid->GetCellX(cluster.transitions[i]), grid->GetCellZ(cluster.transitions[i]));
+        for (int j = 0; j < count; j++)
+        {
+            CellId cell = cluster.transitions[j];
+            cluster.distances[i * count + j] = localDistance[GetLocalIndex(cluster, grid->GetCellX(cell), grid->GetCellZ(cell))];
+        }
+    }
+}
+
+void HierarchicalMap::SearchCluster(const Cluster& cluster, int x, int z)
+{
+    localDistance.assign(CLUSTER_SIZE * CLUSTER_SIZE, -1);
+    localParent.assign(CLUSTER_SIZE * CLUSTER_SIZE, -1);
+    localQueue.clear();
+
+    if (!IsWalkable(x, z))
+        return;
+
+    static const int dx[] = { 0, 0, -1, 1 };
+    static const int dz[] = { -1, 1, 0, 0 };
+
+    localDistance[GetLocalIndex(cluster, x, z)] = 0;
+    localQueue.push_back(grid->GetCellId(x, z));
+
+    for (size_t head = 0; head < localQueue.size(); head++)
+    {
+        CellId cell = localQueue[head];
+        int cellX = grid->GetCellX(cell);
+        int cellZ = grid->GetCellZ(cell);
+        int distance = localDistance[GetLocalIndex(cluster, cellX, cellZ)];
+
+        for (int i = 0; i < 4; i++)
+        {
+            int newX = cellX + dx[i];
+            int newZ = cellZ + dz[i];
+            if (newX < cluster.minX || newX > cluster.maxX || newZ < cluster.minZ || newZ > cluster.maxZ)
+                continue;
+            if (!IsWalkable(newX, newZ))
+                continue;
+
+            int local = GetLocalIndex(cluster, newX, newZ);
+            if (localDistance[local] >= 0)
+                continue;
+
+            localDistance[local] = distance + 1;
+            localParent[local] = cell;
+            localQueue.push_back(grid->GetCellId(newX, newZ));
+        }
+    }
+}
+
+bool HierarchicalMap::FindPath(int startX, int startZ, int goalX, int goalZ, std::vector<CellId>& path, int& nodesExplored, std::vector<CellId>* expandedCells)
+{
+    path.clear();
+    nodesExplored = 0;
+
+    if (!IsWalkable(startX, startZ) || !IsWalkable(goalX, goalZ))
+        return false;
+
+    Refresh();
+
+    const CellId startCell = grid->GetCellId(startX, startZ);
+    const CellId goalCell = grid->GetCellId(goalX, goalZ);
+    const Cluster& startCluster = clusters[GetClusterIndex(startX, startZ)];
+    const Cluster& goalCluster = clusters[GetClusterIndex(goalX, goalZ)];
+
+    // Temporary edges joining start and goal to their clusters' transitions
+    std::vector<int> startDistances(startCluster.transitions.size());
+    SearchCluster(startCluster, startX, startZ);
+    for (size_t i = 0; i < startCluster.transitions.size(); i++)
+    {
+        CellId cell = startCluster.transitions[i];
+        startDistances[i] = localDistance[GetLocalIndex(startCluster, grid->GetCellX(cell), grid->GetCellZ(cell))];
+    }
+    int directDistance = &startCluster == &goalCluster ? localDistance[GetLocalIndex(startCluster, goalX, goalZ)] : -1;
+
+    std::vector<int> goalDistances(goalCluster.transitions.size());
+    SearchCluster(goalCluster, goalX, goalZ);
+    for (size_t i = 0; i < goalCluster.transitions.size(); i++)
+    {
+        CellId cell = goalCluster.transitions[i];
+        goalDistances[i] = localDistance[GetLocalIndex(goalCluster, grid->GetCellX(cell), grid->GetCellZ(cell))];
+    }
+
+    // A* over the abstract graph
+    generation++;
+    if (generation == 0)
+    {
+        for (Node& node : nodes)
+            node.generation = 0;
+        generation = 1;
+    }
+    openSet.Clear();
+
+    const int startNodeId = GetStartNode();
+    const int goalNodeId = GetGoalNode();
+    Node& startNode = nodes[startNodeId];
+    startNode.x = startX;
+    startNode.z = startZ;
+    startNode.gCost = 0;
+    startNode.hCost = static_cast<float>(abs(startX - goalX) + abs(startZ - goalZ));
+    startNode.fCost = startNode.hCost;
+    startNode.parent = -1;
+    startNode.generation = generation;
+    startNode.listState = NODE_OPEN;
+    openSet.Push(nodes, startNodeId);
+
+    bool found = false;
+    while (!openSet.Empty())
+    {
+        const int id = static_cast<int>(openSet.Pop(nodes));
+        Node& node = nodes[id];
+        node.listState = NODE_CLOSED;
+        nodesExplored++;
+        if (expandedCells != nullptr)
+            expandedCells->push_back(grid->GetCellId(node.x, node.z));
+
+        if (id == goalNodeId)
+        {
+            found = true;
+            break;
+        }
+
+        int x = node.x;
+        int z = node.z;
+        int gCost = static_cast<int>(node.gCost);
+
+        // The start joins its cluster's transitions, and the goal when they share it
+        if (id == startNodeId)
+        {
+            for (size_t i = 0; i < startCluster.transitions.size(); i++)
+            {
+                if (startDistances[i] >= 0)
+                    RelaxAbstract(id, startCluster.firstNode + static_cast<int>(i), startCluster.transitions[i], startDistances[i], goalX, goalZ);
+            }
+            if (directDistance >= 0)
+                RelaxAbstract(id, goalNodeId, goalCell, directDistance, goalX, goalZ);
+            continue;
+        }
+
+        const Cluster& cluster = clusters[GetClusterIndex(x, z)];
+        const int transition = id - cluster.firstNode;
+        const int count = static_cast<int>(cluster.transitions.size());
+        for (int j = 0; j < count; j++)
+        {
+            int distance = cluster.distances[transition * count + j];
+            if (j != transition && distance >= 0)
+                RelaxAbstract(id, cluster.firstNode + j, cluster.transitions[j], gCost + distance, goalX, goalZ);
+        }
+
+        // Step across the border into neighboring clusters
+        static const int dx[] = { 0, 0, -1, 1 };
+        static const int dz[] = { -1, 1, 0, 0 };
+        for (int i = 0; i < 4; i++)
+        {
+            int newX = x + dx[i];
+            int newZ = z + dz[i];
+            if (!grid->InBounds(newX, newZ))
+                continue;
+
+            const Cluster& neighbor = clusters[GetClusterIndex(newX, newZ)];
+            if (&neighbor == &cluster)
+                continue;
+            CellId neighborCell = grid->GetCellId(newX, newZ);
+            int neighborTransition = FindTransition(neighbor, neighborCell);
+            if (neighborTransition >= 0)
+                RelaxAbstract(id, neighbor.firstNode + neighborTransition, neighborCell, gCost + 1, goalX, goalZ);
+        }
+
+        if (&cluster == &goalCluster && goalDistances[transition] >= 0)
+            RelaxAbstract(id, goalNodeId, goalCell, gCost + goalDistances[transition], goalX, goalZ);
+    }
+
+    if (!found)
+        return false;
+
+    // Walk the abstract path back, then refine each hop inside its cluster.
+    // A start or goal on a transition appears twice; that hop refines to nothing.
+    std::vector<CellId> waypoints;
+    for (CellId id = goalNodeId; id >= 0; id = nodes[id].parent)
+        waypoints.push_back(grid->GetCellId(nodes[id].x, nodes[id].z));
+    std::reverse(waypoints.begin(), waypoints.end());
+
+    path.push_back(startCell);
+    for (size_t i = 1; i < waypoints.size(); i++)
+        RefineHop(waypoints[i - 1], waypoints[i], path);
+
+    return true;
+}
+
+void HierarchicalMap::RelaxAbstract(int parentNode, int id, CellId cell, int gCost, int goalX, int goalZ)
+{
+    Node& node = nodes[id];
+    NodeListState listState = node.generation == generation ? node.listState : NODE_UNSEEN;
+
+    if (listState == NODE_CLOSED)
+        return;
+
+    if (listState == NODE_UNSEEN)
+    {
+        node.x = grid->GetCellX(cell);
+        node.z = grid->GetCellZ(cell);
+        node.gCost = static_cast<float>(gCost);
+        node.hCost = static_cast<float>(abs(node.x - goalX) + abs(node.z - goalZ));
+        node.fCost = node.gCost + node.hCost;
+        node.parent = parentNode;
+        node.generation = generation;
+        node.listState = NODE_OPEN;
+        openSet.Push(nodes, id);
+    }
+    else if (gCost < node.gCost)
+    {
+        node.gCost = static_cast<float>(gCost);
+        node.fCost = node.gCost + node.hCost;
+        node.parent = parentNode;
+        openSet.DecreaseKey(nodes, id);
+    }
+}
+
+void HierarchicalMap::RefineHop(CellId fromCell, CellId toCell, std::vector<CellId>& path)
+{
+    int fromX = grid->GetCellX(fromCell);
+    int fromZ = grid->GetCellZ(fromCell);
+    int toX = grid->GetCellX(toCell);
+    int toZ = grid->GetCellZ(toCell);
+
+    // Hops between clusters are single steps across the border
+    const Cluster& cluster = clusters[GetClusterIndex(fromX, fromZ)];
+    if (GetClusterIndex(toX, toZ) != GetClusterIndex(fromX, fromZ))
+    {
+        path.push_back(toCell);
+        return;
+    }
+
+    SearchCluster(cluster, fromX, fromZ);
+
+    size_t hopStart = path.size();
+    for (CellId cell = toCell; cell != fromCell; cell = localParent[GetLocalIndex(cluster, grid->GetCellX(cell), grid->GetCellZ(cell))])
+        path.push_back(cell);
+    std::reverse(path.begin() + hopStart, path.end());
+}
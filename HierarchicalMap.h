@@ -0,0 +1,92 @@
+#ifndef HIERARCHICALMAP_H
+#define HIERARCHICALMAP_H
+
+#include <vector>
+#include "Grid.h"
+#include "NodeHeap.h"
+#include "DirtyTracker.h"
+
+// HPA* abstraction of a 4-connected grid. The grid is cut into square clusters;
+// every opening between two clusters contributes one or two transition cells on
+// each side, and each cluster caches the path costs between its own transition
+// cells. Queries search that small graph and then refine each hop inside a single
+// cluster, so their cost follows the cluster count rather than the cell count.
+// Paths are near-optimal: they always pass through transition cells.
+class HierarchicalMap
+{
+public:
+    static const int CLUSTER_SIZE = 10;
+    static const int MAX_ENTRANCE_WIDTH = 6;    // Wider openings get a transition at each end
+
+    HierarchicalMap(const Grid* grid);
+
+    // Full rebuild
+    void Build();
+    bool IsBuilt() const { return built; }
+    // Builds on first use; afterwards rebuilds only the clusters holding cells
+    // whose passability changed since the last call. FindPath calls it first.
+    void Refresh();
+
+    // Fills path with cell indices from start to goal. expandedCells, when given,
+    // receives the abstract nodes in the order they were expanded.
+    bool FindPath(int startX, int startZ, int goalX, int goalZ, std::vector<CellId>& path, int& nodesExplored, std::vector<CellId>* expandedCells = nullptr);
+
+    int GetClusterCount() const { return static_cast<int>(clusters.size()); }
+    int GetTransitionCount() const { return transitionCount; }
+
+private:
+    struct Cluster
+    {
+        int minX, minZ, maxX, maxZ;
+        std::vector<CellId> transitions;    // Cell ids of this cluster's abstract nodes
+        int firstNode;                      // Abstract node of transitions[0]; the rest follow in order
+        std::vector<int> distances;         // Costs between transitions inside the cluster, -1 if unreachable
+    };
+
+    const Grid* grid;
+    bool built;
+    int width, depth;               // Grid size the clusters were laid out for
+    int clustersX, clustersZ;
+    std::vector<Cluster> clusters;
+    int transitionCount;
+    DirtyTracker changes;
+
+    // Per cluster: its transition cells facing the next cluster along +X and +Z.
+    // The matching cell on the other side is always one step across the border.
+    std::vector<std::vector<CellId>> eastBorders;
+    std::vector<std::vector<CellId>> northBorders;
+
+    // Abstract search scratch, invalidated per query by the generation stamp.
+    // One node per transition, numbered cluster by cluster, then one each for
+    // the query's start and goal, so it grows with the transitions rather
+    // than the cells. Node parents are node ids.
+    std::vector<Node> nodes;
+    NodeHeap openSet;
+    unsigned int generation;
+
+    // Breadth-first search confined to one cluster
+    std::vector<int> localDistance;
+    std::vector<CellId> localParent;
+    std::vector<CellId> localQueue;
+
+    HierarchicalMap(const HierarchicalMap&) = delete;
+    HierarchicalMap& operator=(const HierarchicalMap&) = delete;
+
+    bool IsWalkable(int x, int z) const;
+    int GetClusterIndex(int x, int z) const { return (x / CLUSTER_SIZE) * clustersZ + z / CLUSTER_SIZE; }
+    int GetLocalIndex(const Cluster& cluster, int x, int z) const { return (x - cluster.minX) * CLUSTER_SIZE + (z - cluster.minZ); }
+    int FindTransition(const Cluster& cluster, CellId cell) const;
+    int GetStartNode() const { return transitionCount; }
+    int GetGoalNode() const { return transitionCount + 1; }
+
+    bool BuildBorder(int clusterX, int clusterZ, bool east);
+    void BuildCluster(int clusterIndex);
+    void SearchCluster(const Cluster& cluster, int x, int z);
+    // Gives every transition its node id and sizes the node pool to match
+    void NumberNodes();
+
+    void RelaxAbstract(int parentNode, int id, CellId cell, int gCost, int goalX, int goalZ);
+    void RefineHop(CellId fromCell, CellId toCell, std::vector<CellId>& path);
+};
+
+#endif
@@ -0,0 +1,242 @@
+#include "JumpPointTable.h"
+#include <algorithm>
+
+const int JumpPointTable::DIR_X[DIRECTIONS] = { 1, 1, 0, -1, -1, -1, 0, 1 };
+const int JumpPointTable::DIR_Z[DIRECTIONS] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+
+JumpPointTable::JumpPointTable(const Grid* grid)
+    : grid(grid)
+    , built(false)
+    , changes(grid, DIRTY_PASSABILITY)
+{
+}
+
+int JumpPointTable::GetDirection(int dx, int dz)
+{
+    for (int d = 0; d < DIRECTIONS; d++)
+    {
+        if (DIR_X[d] == dx && DIR_Z[d] == dz)
+            return d;
+    }
+    return -1;
+}
+
+void JumpPointTable::Build()
+{
+    const int width = grid->GetWidth();
+    const int depth = grid->GetDepth();
+    distances.assign(static_cast<size_t>(grid->GetCellIdLimit()) * DIRECTIONS, 0);
+
+    for (int z = 0; z < depth; z++)
+        BuildRow(z);
+    for (int x = 0; x < width; x++)
+        BuildColumn(x);
+
+    // Diagonals read the cell one step ahead, so sweep from the far corner backwards
+    for (int d = 1; d < DIRECTIONS; d += 2)
+    {
+        int dx = DIR_X[d];
+        int dz = DIR_Z[d];
+        for (int i = 0; i < width; i++)
+        {
+            int x = dx > 0 ? width - 1 - i : i;
+            for (int j = 0; j < depth; j++)
+            {
+                int z = dz > 0 ? depth - 1 - j : j;
+                UpdateDiagonal(x, z, d);
+            }
+        }
+    }
+
+    built = true;
+    changes.Clear();
+}
+
+void JumpPointTable::Refresh()
+{
+    if (!built || changes.IsAllDirty() ||
+        distances.size() != static_cast<size_t>(grid->GetCellIdLimit()) * DIRECTIONS)
+    {
+        Build();
+        return;
+    }
+    if (!changes.IsDirty())
+        return;
+
+    std::vector<DirtyRect> rects;
+    changes.GetDirtyRects(rects);
+    changes.Clear();
+
+    // Straight distances depend on the cell's own row or column and the two
+    // beside it. Rows and columns shared by several dirty rects are rebuilt once.
+    const int width = grid->GetWidth();
+    const int depth = grid->GetDepth();
+    std::vector<char> rowDirty(depth, 0), columnDirty(width, 0);
+    for (const DirtyRect& rect : rects)
+    {
+        for (int z = std::max(0, rect.minZ - 1); z <= std::min(depth - 1, rect.maxZ + 1); z++)
+            rowDirty[z] = 1;
+        for (int x = std::max(0, rect.minX - 1); x <= std::min(width - 1, rect.maxX + 1); x++)
+            columnDirty[x] = 1;
+    }
+
+    std::vector<int> rows, columns;
+    for (int z = 0; z < depth; z++)
+        if (rowDirty[z])
+            rows.push_back(z);
+    for (int x = 0; x < width; x++)
+        if (columnDirty[x])
+            columns.push_back(x);
+
+    // Every row and column touched is a full rebuild anyway
+    if (static_cast<CellId>(rows.size()) * width + static_cast<CellId>(columns.size()) * depth > grid->GetCellCount())
+    {
+        Build();
+        return;
+    }
+
+    for (int z : rows)
+        BuildRow(z);
+    for (int x : columns)
+        BuildColumn(x);
+
+    UpdateDiagonals(rows, columns);
+}
+
+bool JumpPointTable::IsWalkable(int x, int z) const
+{
+    return grid->IsPassable(x, z);
+}
+
+bool JumpPointTable::IsStraightJumpPoint(int x, int z, int dx, int dz) const
+{
+    // Forced neighbor: a side cell that was blocked one step back
+    if (dx != 0)
+    {
+        return (IsWalkable(x, z - 1) && !IsWalkable(x - dx, z - 1)) ||
+               (IsWalkable(x, z + 1) && !IsWalkable(x - dx, z + 1));
+    }
+    return (IsWalkable(x - 1, z) && !IsWalkable(x - 1, z - dz)) ||
+           (IsWalkable(x + 1, z) && !IsWalkable(x + 1, z - dz));
+}
+
+void JumpPointTable::BuildRow(int z)
+{
+    // Directions 0 (+X) and 4 (-X); each pass carries the running distance backwards
+    for (int pass = 0; pass < 2; pass++)
+    {
+        int direction = pass == 0 ? 0 : 4;
+        int dx = DIR_X[direction];
+        int distance = 0;
+
+        for (int i = 0; i < grid->GetWidth(); i++)
+        {
+            int x = dx > 0 ? grid->GetWidth() - 1 - i : i;
+            int nextX = x + dx;
+
+            if (!IsWalkable(nextX, z))
+                distance = 0;
+            else if (IsStraightJumpPoint(nextX, z, dx, 0))
+                distance = 1;
+            else
+                distance = distance > 0 ? distance + 1 : distance - 1;
+
+            SetDistance(x, z, direction, IsWalkable(x, z) ? distance : 0);
+        }
+    }
+}
+
+void JumpPointTable::BuildColumn(int x)
+{
+    // Directions 2 (+Z) and 6 (-Z)
+    for (int pass = 0; pass < 2; pass++)
+    {
+        int direction = pass == 0 ? 2 : 6;
+        int dz = DIR_Z[direction];
+        int distance = 0;
+
+        for (int i = 0; i < grid->GetDepth(); i++)
+        {
+            int z = dz > 0 ? grid->GetDepth() - 1 - i : i;
+            int nextZ = z + dz;
+
+            if (!IsWalkable(x, nextZ))
+                distance = 0;
+            else if (IsStraightJumpPoint(x, nextZ, 0, dz))
+                distance = 1;
+            else
+                distance = distance > 0 ? distance + 1 : distance - 1;
+
+            SetDistance(x, z, direction, IsWalkable(x, z) ? distance : 0);
+        }
+    }
+}
+
+bool JumpPointTable::UpdateDiagonal(int x, int z, int direction)
+{
+    int dx = DIR_X[direction];
+    int dz = DIR_Z[direction];
+    int nextX = x + dx;
+    int nextZ = z + dz;
+    int distance = 0;
+
+    if (IsWalkable(x, z) && IsWalkable(nextX, nextZ) && IsWalkable(nextX, z) && IsWalkable(x, nextZ))
+    {
+        // A diagonal cell is a jump point when either straight component reaches one
+        if (GetDistance(nextX, nextZ, GetDirection(dx, 0)) > 0 || GetDistance(nextX, nextZ, GetDirection(0, dz)) > 0)
+        {
+            distance = 1;
+        }
+        else
+        {
+            int ahead = GetDistance(nextX, nextZ, direction);
+            distance = ahead > 0 ? ahead + 1 : ahead - 1;
+        }
+    }
+
+    bool changed = GetDistance(x, z, direction) != distance;
+    SetDistance(x, z, direction, distance);
+    return changed;
+}
+
+void JumpPointTable::UpdateDiagonals(const std::vector<int>& rows, const std::vector<int>& columns)
+{
+    // A diagonal entry changes when the cell one step ahead lies in a rebuilt row or
+    // column; those seeds cover every cell next to the edit. Seeds are visited from
+    // the far end of each diagonal, and each walks backwards while values keep changing.
+    const int width = grid->GetWidth();
+    const int depth = grid->GetDepth();
+
+    std::vector<std::pair<int, int>> seeds;
+    for (int d = 1; d < DIRECTIONS; d += 2)
+    {
+        int dx = DIR_X[d];
+        int dz = DIR_Z[d];
+
+        seeds.clear();
+        for (int z : rows)
+            for (int x = 0; x < width; x++)
+                seeds.push_back(std::make_pair(x - dx, z - dz));
+        for (int x : columns)
+            for (int z = 0; z < depth; z++)
+                seeds.push_back(std::make_pair(x - dx, z - dz));
+
+        std::sort(seeds.begin(), seeds.end(), [dx, dz](const std::pair<int, int>& a, const std::pair<int, int>& b)
+        {
+            return a.first * dx + a.second * dz > b.first * dx + b.second * dz;
+        });
+
+        for (const std::pair<int, int>& seed : seeds)
+        {
+            int x = seed.first;
+            int z = seed.second;
+            while (grid->InBounds(x, z))
+            {
+                if (!UpdateDiagonal(x, z, d))
+                    break;
+                x -= dx;
+                z -= dz;
+            }
+        }
+    }
+}
@@ -0,0 +1,61 @@
+#ifndef JUMPPOINTTABLE_H
+#define JUMPPOINTTABLE_H
+
+#include <cstdint>
+#include <vector>
+#include "Grid.h"
+#include "DirtyTracker.h"
+
+// JPS+ preprocessing: eight jump distances per cell, so queries never scan.
+// For each direction a positive value is the step count to the next jump point;
+// zero or a negative value is minus the number of open steps before a wall.
+// Directions run counter-clockwise from +X; even indices are straight, odd diagonal.
+// The table follows the same no-corner-cutting rules as Pathfinding's JPS mode.
+class JumpPointTable
+{
+public:
+    static const int DIRECTIONS = 8;
+    static const int DIR_X[DIRECTIONS];
+    static const int DIR_Z[DIRECTIONS];
+
+    JumpPointTable(const Grid* grid);
+
+    // Full rebuild
+    void Build();
+    bool IsBuilt() const { return built; }
+    // Builds on first use; afterwards redoes only the rows and columns around
+    // cells whose passability changed since the last call
+    void Refresh();
+
+    int GetDistance(int x, int z, int direction) const
+    {
+        return distances[grid->GetCellId(x, z) * DIRECTIONS + direction];
+    }
+
+    static int GetDirection(int dx, int dz);
+
+private:
+    const Grid* grid;
+    // Rows and columns can be longer than a short can count
+    std::vector<std::int32_t> distances;
+    bool built;
+    DirtyTracker changes;
+
+    JumpPointTable(const JumpPointTable&) = delete;
+    JumpPointTable& operator=(const JumpPointTable&) = delete;
+
+    bool IsWalkable(int x, int z) const;
+    bool IsStraightJumpPoint(int x, int z, int dx, int dz) const;
+
+    void SetDistance(int x, int z, int direction, int distance)
+    {
+        distances[grid->GetCellId(x, z) * DIRECTIONS + direction] = static_cast<std::int32_t>(distance);
+    }
+
+    void BuildRow(int z);
+    void BuildColumn(int x);
+    bool UpdateDiagonal(int x, int z, int direction);
+    void UpdateDiagonals(const std::vector<int>& rows, const std::vector<int>& columns);
+};
+
+#endif
@@ -0,0 +1,231 @@
+#include "LandmarkTable.h"
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <thread>
+
+const int LandmarkTable::UNREACHABLE;
+
+LandmarkTable::LandmarkTable(const Grid* grid, int landmarkCount)
+    : grid(grid)
+    , landmarkCount(landmarkCount)
+    , changes(grid, DIRTY_PASSABILITY)
+    , width(0)
+    , depth(0)
+{
+}
+
+void LandmarkTable::Refresh()
+{
+    if (!changes.IsDirty())
+        return;
+
+    // Keep the landmarks while they stay walkable, so edits only cost the fields
+    bool keepLandmarks = !landmarks.empty() && grid->GetWidth() == width && grid->GetDepth() == depth;
+    for (CellId cell : landmarks)
+    {
+        if (!grid->IsPassable(grid->GetCellX(cell), grid->GetCellZ(cell)))
+            keepLandmarks = false;
+    }
+
+    if (keepLandmarks)
+        ComputeFields();
+    else
+        SelectLandmarks();
+
+    changes.Clear();
+}
+
+float LandmarkTable::Estimate(CellId cell, CellId targetCell) const
+{
+    const int* from = &distances[static_cast<size_t>(cell) * landmarkCount];
+    const int* to = &distances[static_cast<size_t>(targetCell) * landmarkCount];
+
+    int best = 0;
+    for (int i = 0; i < static_cast<int>(landmarks.size()); i++)
+    {
+        // A landmark that cannot reach both cells says nothing about them
+        if (from[i] == UNREACHABLE || to[i] == UNREACHABLE)
+            continue;
+        best = std::max(best, abs(from[i] - to[i]));
+    }
+    return static_cast<float>(best);
+}
+
+void LandmarkTable::SelectLandmarks()
+{
+    const CellId cellCount = grid->GetCellIdLimit();
+    landmarks.clear();
+    width = grid->GetWidth();
+    depth = grid->GetDepth();
+
+    // Distance from each cell to its nearest chosen landmark; cells no landmark
+    // reaches yet count as infinitely far, so other regions get covered too
+    std::vector<int> nearest;
+    std::vector<CellId> queue;
+
+    // Seed with the first walkable cell; its farthest cell becomes the first landmark
+    CellId seed = -1;
+    for (CellId cell = 0; cell < cellCount && seed < 0; cell++)
+    {
+        if (grid->IsPassable(grid->GetCellX(cell), grid->GetCellZ(cell)))
+            seed = cell;
+    }
+    if (seed < 0)
+    {
+        fields.clear();
+        PackFields();
+        return;
+    }
+
+    // Breadth-first order ends on a farthest cell
+    ComputeField(seed, nearest, queue);
+    landmarks.push_back(queue.back());
+    ComputeField(landmarks[0], nearest, queue);
+
+    // Each pick depends on the ones before it, so selection itself is serial.
+    // It only keeps the nearest distances, which a new landmark can improve
+    // on just around itself; the full fields are computed in parallel after.
+    while (static_cast<int>(landmarks.size()) < landmarkCount)
+    {
+        // Next landmark: the walkable cell farthest from every landmark so far
+        CellId next = -1;
+        int nextDistance = -1;
+        for (CellId cell = 0; cell < cellCount; cell++)
+        {
+            if (!grid->IsPassable(grid->GetCellX(cell), grid->GetCellZ(cell)))
+                continue;
+            int distance = nearest[cell] == UNREACHABLE ? std::numeric_limits<int>::max() : nearest[cell];
+            if (distance > nextDistance)
+            {
+                next = cell;
+                nextDistance = distance;
+            }
+        }
+
+        // Fewer walkable cells than landmarks
+        if (nextDistance <= 0)
+            break;
+
+        landmarks.push_back(next);
+        UpdateNearest(next, nearest, queue);
+    }
+
+    ComputeFields();
+}
+
+void LandmarkTable::ComputeFields()
+{
+    const int count = static_cast<int>(landmarks.size());
+    fields.assign(count, std::vector<int>());
+
+    // Fields are independent, so split the landmarks across worker threads.
+    // Each writes its own contiguous field; they are interleaved afterwards.
+    int workerCount = static_cast<int>(std::thread::hardware_concurrency());
+    workerCount = std::max(1, std::min(workerCount, count));
+
+    std::vector<std::thread> workers;
+    for (int w = 1; w < workerCount; w++)
+    {
+        workers.emplace_back([this, w, workerCount, count]()
+        {
+            std::vector<CellId> queue;
+            for (int i = w; i < count; i += workerCount)
+                ComputeField(landmarks[i], fields[i], queue);
+        });
+    }
+
+    std::vector<CellId> queue;
+    for (int i = 0; i < count; i += workerCount)
+        ComputeField(landmarks[i], fields[i], queue);
+
+    for (std::thread& worker : workers)
+        worker.join();
+
+    PackFields();
+}
+
+void LandmarkTable::PackFields()
+{
+    // Interleave so one heuristic evaluation reads a single run of memory
+    const CellId cellCount = grid->GetCellIdLimit();
+    distances.assign(static_cast<size_t>(cellCount) * landmarkCount, UNREACHABLE);
+
+    for (size_t i = 0; i < fields.size(); i++)
+    {
+        for (CellId cell = 0; cell < cellCount; cell++)
+            distances[static_cast<size_t>(cell) * landmarkCount + i] = fields[i][cell];
+    }
+    fields.clear();
+}
+
+void LandmarkTable::ComputeField(CellId source, std::vector<int>& field, std::vector<CellId>& queue) const
+{
+    static const int dx[] = { 0, 0, -1, 1 };
+    static const int dz[] = { -1, 1, 0, 0 };
+
+    // Breadth-first: every move costs 1
+    field.assign(static_cast<size_t>(grid->GetCellIdLimit()), UNREACHABLE);
+    queue.clear();
+    queue.push_back(source);
+    field[source] = 0;
+
+    for (size_t head = 0; head < queue.size(); head++)
+    {
+        CellId cell = queue[head];
+        int x = grid->GetCellX(cell);
+        int z = grid->GetCellZ(cell);
+        int distance = field[cell];
+
+        for (int i = 0; i < 4; i++)
+        {
+            int newX = x + dx[i];
+            int newZ = z + dz[i];
+            if (!grid->IsPassable(newX, newZ))
+                continue;
+
+            CellId next = grid->GetCellId(newX, newZ);
+            if (field[next] != UNREACHABLE)
+                continue;
+
+            field[next] = distance + 1;
+            queue.push_back(next);
+        }
+    }
+}
+
+void LandmarkTable::UpdateNearest(CellId source, std::vector<int>& nearest, std::vector<CellId>& queue) const
+{
+    static const int dx[] = { 0, 0, -1, 1 };
+    static const int dz[] = { -1, 1, 0, 0 };
+
+    // Breadth-first from the new landmark, stopping wherever an older one is at
+    // least as close. Every cell the new landmark is closer to lies on a
+    // shortest path of cells it is also closer to, so none are missed.
+    queue.clear();
+    queue.push_back(source);
+    nearest[source] = 0;
+
+    for (size_t head = 0; head < queue.size(); head++)
+    {
+        CellId cell = queue[head];
+        int x = grid->GetCellX(cell);
+        int z = grid->GetCellZ(cell);
+        int distance = nearest[cell] + 1;
+
+        for (int i = 0; i < 4; i++)
+        {
+            int newX = x + dx[i];
+            int newZ = z + dz[i];
+            if (!grid->IsPassable(newX, newZ))
+                continue;
+
+            CellId next = grid->GetCellId(newX, newZ);
+            if (nearest[next] != UNREACHABLE && nearest[next] <= distance)
+                continue;
+
+            nearest[next] = distance;
+            queue.push_back(next);
+        }
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef LANDMARKTABLE_H
+#define LANDMARKTABLE_H
+
+#include <vector>
+#include "Grid.h"
+#include "DirtyTracker.h"
+
+// ALT heuristic data: exact 4-connected distances from a few landmark cells.
+// By the triangle inequality |d(L, goal) - d(L, cell)| never overestimates the
+// remaining cost, and the largest bound over all landmarks is used.
+// Landmarks are chosen by farthest-point selection, and their distance fields
+// are computed in parallel; after grid edits the same landmarks are kept and
+// only the fields are recomputed.
+class LandmarkTable
+{
+public:
+    LandmarkTable(const Grid* grid, int landmarkCount);
+
+    // Bring landmarks and fields up to date with the grid; cheap when nothing changed
+    void Refresh();
+    bool IsCurrent() const { return !changes.IsDirty(); }
+
+    float Estimate(CellId cell, CellId targetCell) const;
+
+    int GetLandmarkCount() const { return static_cast<int>(landmarks.size()); }
+    CellId GetLandmark(int index) const { return landmarks[index]; }
+
+private:
+    static const int UNREACHABLE = -1;
+
+    const Grid* grid;
+    int landmarkCount;
+    DirtyTracker changes;           // Any edit can change distances anywhere, so only "whether" matters
+    int width, depth;               // Grid size the landmarks were chosen for
+    std::vector<CellId> landmarks;
+    std::vector<int> distances;     // cell * landmarkCount + landmark, UNREACHABLE if cut off
+    std::vector<std::vector<int>> fields;  // One contiguous field per landmark while computing
+
+    LandmarkTable(const LandmarkTable&) = delete;
+    LandmarkTable& operator=(const LandmarkTable&) = delete;
+
+    void SelectLandmarks();
+    void ComputeFields();
+    void ComputeField(CellId source, std::vector<int>& field, std::vector<CellId>& queue) const;
+    void UpdateNearest(CellId source, std::vector<int>& nearest, std::vector<CellId>& queue) const;
+    void PackFields();
+};
+
+#endif
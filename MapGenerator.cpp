@@ -0,0 +1,442 @@
+#include "MapGenerator.h"
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+const int MapGenerator::MAX_SIDE;
+
+namespace
+{
+    // Maps with fewer tiles are generated on the calling thread
+    const long long PARALLEL_TILES = 1 << 18;
+
+    // Maze cells per region side; each region is carved on its own
+    const int MAZE_REGION = 128;
+
+    // One room, or a corridor junction, per block of this many tiles a side
+    const int ROOM_BLOCK = 16;
+
+    const int CAVE_PASSES = 5;
+
+    // One byte per tile, row-major, 1 where the tile is an obstacle
+    typedef std::vector<unsigned char> TileMask;
+
+    // SplitMix64 finalizer. Hashing (seed, index) rather than drawing from a
+    // shared engine is what lets rows be filled in any order on any thread.
+    std::uint64_t Hash(std::uint64_t value)
+    {
+        value += 0x9e3779b97f4a7c15ull;
+        value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+        value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+        return value ^ (value >> 31);
+    }
+
+    // Engines are seeded from a hash and only their raw output is used:
+    // std:: distributions differ between standard libraries, raw mt19937 does not
+    std::mt19937 MakeEngine(unsigned int seed, std::uint64_t stream)
+    {
+        return std::mt19937(static_cast<std::uint32_t>(Hash(Hash(seed) + stream)));
+    }
+
+    // Runs work(i) for i in [0, count), split round-robin across threads when
+    // the map is large enough to be worth it. Calls for different i must not
+    // write the same bytes.
+    template<typename Work>
+    void ParallelFor(int count, long long tiles, Work work)
+    {
+        int workerCount = 1;
+        if (tiles >= PARALLEL_TILES)
+            workerCount = std::max(1, std::min(static_cast<int>(std::thread::hardware_concurrency()), count));
+
+        std::vector<std::thread> workers;
+        for (int w = 1; w < workerCount; w++)
+        {
+            workers.emplace_back([&work, w, workerCount, count]()
+            {
+                for (int i = w; i < count; i += workerCount)
+                    work(i);
+            });
+        }
+
+        for (int i = 0; i < count; i += workerCount)
+            work(i);
+
+        for (std::thread& worker : workers)
+            worker.join();
+    }
+
+    // Random spanning tree of a columns x rows lattice by recursive
+    // backtracking (explicit stack). Edges are pairs of lattice indices.
+    void SpanningTree(int columns, int rows, std::mt19937& rng, std::vector<std::pair<int, int>>& edges)
+    {
+        edges.clear();
+        std::vector<unsigned char> visited(static_cast<size_t>(columns) * rows, 0);
+        std::vector<int> stack(1, 0);
+        visited[0] = 1;
+
+        while (!stack.empty())
+        {
+            int cell = stack.back();
+            int x = cell % columns, z = cell / columns;
+
+            int options[4];
+            int count = 0;
+            if (x > 0 && !visited[cell - 1]) options[count++] = cell - 1;
+            if (x + 1 < columns && !visited[cell + 1]) options[count++] = cell + 1;
+            if (z > 0 && !visited[cell - columns]) options[count++] = cell - columns;
+            if (z + 1 < rows && !visited[cell + columns]) options[count++] = cell + columns;
+
+            if (count == 0)
+            {
+                stack.pop_back();
+                continue;
+            }
+
+            int next = options[rng() % count];
+            visited[next] = 1;
+            edges.push_back(std::make_pair(cell, next));
+            stack.push_back(next);
+        }
+    }
+
+    void FillRandom(TileMask& mask, int width, int depth, unsigned int seed, float density)
+    {
+        // Top 24 bits of the hash against the density in 1/2^24 steps
+        const std::uint64_t threshold = static_cast<std::uint64_t>(density * 16777216.0);
+        const std::uint64_t base = Hash(seed);
+
+        ParallelFor(depth, static_cast<long long>(width) * depth, [&](int z)
+        {
+            size_t row = static_cast<size_t>(z) * width;
+            for (int x = 0; x < width; x++)
+                mask[row + x] = (Hash(base + row + x) >> 40) < threshold;
+        });
+    }
+
+    void CarveMaze(TileMask& mask, int width, int depth, unsigned int seed)
+    {
+        // Cells sit on odd coordinates, walls between them on even ones
+        const int cellsX = (width - 1) / 2;
+        const int cellsZ = (depth - 1) / 2;
+        const int regionsX = (cellsX + MAZE_REGION - 1) / MAZE_REGION;
+        const int regionsZ = (cellsZ + MAZE_REGION - 1) / MAZE_REGION;
+
+        std::fill(mask.begin(), mask.end(), 1);
+
+        // Each region is a perfect maze of its own...
+        ParallelFor(regionsX * regionsZ, static_cast<long long>(width) * depth, [&](int region)
+        {
+            const int firstX = (region % regionsX) * MAZE_REGION;
+            const int firstZ = (region / regionsX) * MAZE_REGION;
+            const int columns = std::min(MAZE_REGION, cellsX - firstX);
+            const int rows = std::min(MAZE_REGION, cellsZ - firstZ);
+
+            for (int z = 0; z < rows; z++)
+            {
+                for (int x = 0; x < columns; x++)
+                    mask[static_cast<size_t>(2 * (firstZ + z) + 1) * width + 2 * (firstX + x) + 1] = 0;
+            }
+
+            std::mt19937 rng = MakeEngine(seed, 1 + region);
+            std::vector<std::pair<int, int>> edges;
+            SpanningTree(columns, rows, rng, edges);
+            for (const std::pair<int, int>& edge : edges)
+            {
+                // The wall between two cells is at the sum of their cell coordinates, plus one
+                int x = 2 * firstX + edge.first % columns + edge.second % columns + 1;
+                int z = 2 * firstZ + edge.first / columns + edge.second / columns + 1;
+                mask[static_cast<size_t>(z) * width + x] = 0;
+            }
+        });
+
+        // ...and a spanning tree over the regions opens one door per tree
+        // edge, so the whole map stays a single perfect maze
+        std::mt19937 rng = MakeEngine(seed, 0);
+        std::vector<std::pair<int, int>> edges;
+        SpanningTree(regionsX, regionsZ, rng, edges);
+        for (const std::pair<int, int>& edge : edges)
+        {
+            const int low = std::min(edge.first, edge.second);
+            const int high = std::max(edge.first, edge.second);
+            const int firstX = (high % regionsX) * MAZE_REGION;
+            const int firstZ = (high / regionsX) * MAZE_REGION;
+
+            if (low / regionsX == high / regionsX)
+            {
+                int z = firstZ + static_cast<int>(rng() % std::min(MAZE_REGION, cellsZ - firstZ));
+                mask[static_cast<size_t>(2 * z + 1) * width + 2 * firstX] = 0;
+            }
+            else
+            {
+                int x = firstX + static_cast<int>(rng() % std::min(MAZE_REGION, cellsX - firstX));
+                mask[static_cast<size_t>(2 * firstZ) * width + 2 * x + 1] = 0;
+            }
+        }
+    }
+
+    struct Room
+    {
+        int minX, minZ, maxX, maxZ;
+    };
+
+    void CarveRooms(TileMask& mask, int width, int depth, unsigned int seed)
+    {
+        const int blockWidth = std::min(ROOM_BLOCK, width);
+        const int blockDepth = std::min(ROOM_BLOCK, depth);
+        const int blocksX = width / blockWidth;
+        const int blocksZ = depth / blockDepth;
+        const std::uint64_t base = Hash(seed);
+
+        std::fill(mask.begin(), mask.end(), 1);
+
+        // One room per block, inset by a tile so neighbors never merge.
+        // A quarter of the blocks get a single-tile junction instead.
+        std::vector<Room> rooms(static_cast<size_t>(blocksX) * blocksZ);
+        for (int block = 0; block < blocksX * blocksZ; block++)
+        {
+            std::uint64_t bits = Hash(base + block);
+            const int spanX = blockWidth - 2, spanZ = blockDepth - 2;
+
+            int roomWidth = 1, roomDepth = 1;
+            if ((bits & 3) != 0)
+            {
+                int minWidth = std::min(3, spanX), minDepth = std::min(3, spanZ);
+                roomWidth = minWidth + static_cast<int>((bits >> 8) % (spanX - minWidth + 1));
+                roomDepth = minDepth + static_cast<int>((bits >> 20) % (spanZ - minDepth + 1));
+            }
+
+            Room& room = rooms[block];
+            room.minX = (block % blocksX) * blockWidth + 1 + static_cast<int>((bits >> 32) % (spanX - roomWidth + 1));
+            room.minZ = (block / blocksX) * blockDepth + 1 + static_cast<int>((bits >> 44) % (spanZ - roomDepth + 1));
+            room.maxX = room.minX + roomWidth - 1;
+            room.maxZ = room.minZ + roomDepth - 1;
+        }
+
+        // A block row only touches its own tile rows
+        ParallelFor(blocksZ, static_cast<long long>(width) * depth, [&](int row)
+        {
+            for (int block = row * blocksX; block < (row + 1) * blocksX; block++)
+            {
+                const Room& room = rooms[block];
+                for (int z = room.minZ; z <= room.maxZ; z++)
+                {
+                    std::fill(mask.begin() + static_cast<size_t>(z) * width + room.minX,
+                        mask.begin() + static_cast<size_t>(z) * width + room.maxX + 1, 0);
+                }
+            }
+        });
+
+        // Corridors follow a spanning tree over the blocks, plus a few extra
+        // links for loops. Each bends once, inside the two blocks it joins.
+        std::mt19937 rng = MakeEngine(seed, 0);
+        std::vector<std::pair<int, int>> links;
+        SpanningTree(blocksX, blocksZ, rng, links);
+        for (int block = 0; block < blocksX * blocksZ; block++)
+        {
+            if (block % blocksX + 1 < blocksX && rng() % 8 == 0)
+                links.push_back(std::make_pair(block, block + 1));
+            if (block / blocksX + 1 < blocksZ && rng() % 8 == 0)
+                links.push_back(std::make_pair(block, block + blocksX));
+        }
+
+        for (const std::pair<int, int>& link : links)
+        {
+            const Room& a = rooms[link.first];
+            const Room& b = rooms[link.second];
+            int ax = (a.minX + a.maxX) / 2, az = (a.minZ + a.maxZ) / 2;
+            int bx = (b.minX + b.maxX) / 2, bz = (b.minZ + b.maxZ) / 2;
+
+            // Blocks side by side share tile rows and blocks above each other
+            // share columns, so the legs run along the shared ones
+            bool sameRow = link.first / blocksX == link.second / blocksX;
+            int legZ = sameRow ? az : bz;
+            int legX = sameRow ? bx : ax;
+
+            for (int x = std::min(ax, bx); x <= std::max(ax, bx); x++)
+                mask[static_cast<size_t>(legZ) * width + x] = 0;
+            for (int z = std::min(az, bz); z <= std::max(az, bz); z++)
+                mask[static_cast<size_t>(z) * width + legX] = 0;
+        }
+    }
+
+    // Fills every walkable pocket except the largest 4-connected one
+    void KeepLargestRegion(TileMask& mask, int width, int depth)
+    {
+        std::vector<int> labels(mask.size(), -1);
+        std::vector<size_t> queue;
+        int bestLabel = -1;
+        size_t bestSize = 0;
+        int label = 0;
+
+        for (size_t seedTile = 0; seedTile < mask.size(); seedTile++)
+        {
+            if (mask[seedTile] || labels[seedTile] >= 0)
+                continue;
+
+            queue.assign(1, seedTile);
+            labels[seedTile] = label;
+            for (size_t head = 0; head < queue.size(); head++)
+            {
+                size_t tile = queue[head];
+                int x = static_cast<int>(tile % width);
+                size_t neighbors[4];
+                int count = 0;
+                if (x > 0) neighbors[count++] = tile - 1;
+                if (x + 1 < width) neighbors[count++] = tile + 1;
+                if (tile >= static_cast<size_t>(width)) neighbors[count++] = tile - width;
+                if (tile + width < mask.size()) neighbors[count++] = tile + width;
+
+                for (int i = 0; i < count; i++)
+                {
+                    if (!mask[neighbors[i]] && labels[neighbors[i]] < 0)
+                    {
+                        labels[neighbors[i]] = label;
+                        queue.push_back(neighbors[i]);
+                    }
+                }
+            }
+
+            if (queue.size() > bestSize)
+            {
+                bestSize = queue.size();
+                bestLabel = label;
+            }
+            label++;
+        }
+
+        ParallelFor(depth, static_cast<long long>(width) * depth, [&](int z)
+        {
+            size_t row = static_cast<size_t>(z) * width;
+            for (int x = 0; x < width; x++)
+            {
+                if (!mask[row + x] && labels[row + x] != bestLabel)
+                    mask[row + x] = 1;
+            }
+        });
+    }
+
+    void GrowCaves(TileMask& mask, int width, int depth, unsigned int seed, float density)
+    {
+        FillRandom(mask, width, depth, seed, density);
+
+        // 4-5 rule: a tile becomes wall when at least five of the nine tiles
+        // around and including it are wall, counting the border as wall
+        TileMask next(mask.size());
+        for (int pass = 0; pass < CAVE_PASSES; pass++)
+        {
+            ParallelFor(depth, static_cast<long long>(width) * depth, [&](int z)
+            {
+                // Column sums of the three rows, padded with a wall column each side
+                std::vector<unsigned char> columns(width + 2, 3);
+                for (int nz = z - 1; nz <= z + 1; nz++)
+                {
+                    if (nz < 0 || nz >= depth)
+                        continue;
+                    const unsigned char* row = &mask[static_cast<size_t>(nz) * width];
+                    for (int x = 0; x < width; x++)
+                        columns[x + 1] -= 1 - row[x];
+                }
+
+                unsigned char* out = &next[static_cast<size_t>(z) * width];
+                for (int x = 0; x < width; x++)
+                    out[x] = columns[x] + columns[x + 1] + columns[x + 2] >= 5;
+            });
+            mask.swap(next);
+        }
+
+        KeepLargestRegion(mask, width, depth);
+    }
+}
+
+bool MapGenerator::Generate(Grid& grid, MapPattern pattern, int width, int depth,
+    unsigned int seed, float density, std::string& error)
+{
+    if (width <= 0 || depth <= 0 || width > MAX_SIDE || depth > MAX_SIDE)
+    {
+        error = "size must be between 1 and " + std::to_string(MAX_SIDE);
+        return false;
+    }
+    if ((pattern == PATTERN_MAZE || pattern == PATTERN_ROOMS) && (width < 3 || depth < 3))
+    {
+        error = std::string(GetPatternName(pattern)) + " needs at least 3x3 tiles";
+        return false;
+    }
+    density = std::max(0.0f, std::min(1.0f, density));
+
+    TileMask mask(static_cast<size_t>(width) * depth);
+    switch (pattern)
+    {
+    case PATTERN_RANDOM:
+        FillRandom(mask, width, depth, seed, density);
+        break;
+    case PATTERN_MAZE:
+        CarveMaze(mask, width, depth, seed);
+        break;
+    case PATTERN_ROOMS:
+        CarveRooms(mask, width, depth, seed);
+        break;
+    case PATTERN_CAVES:
+        GrowCaves(mask, width, depth, seed, density);
+        break;
+    default:
+        error = "unknown pattern";
+        return false;
+    }
+
+    grid.BeginBatch();
+    grid.Resize(width, depth);
+    for (int z = 0; z < depth; z++)
+    {
+        const unsigned char* row = &mask[static_cast<size_t>(z) * width];
+        for (int x = 0; x < width; x++)
+        {
+            if (row[x])
+                grid.SetTile(x, z, OBSTACLE);
+        }
+    }
+
+    TileMask::const_iterator first = std::find(mask.begin(), mask.end(), 0);
+    if (first != mask.end())
+    {
+        size_t last = mask.size() - 1 - (std::find(mask.rbegin(), mask.rend(), 0) - mask.rbegin());
+        size_t start = first - mask.begin();
+        grid.SetStart(static_cast<int>(start % width), static_cast<int>(start / width));
+        if (last != start)
+            grid.SetGoal(static_cast<int>(last % width), static_cast<int>(last / width));
+    }
+    grid.EndBatch();
+    return true;
+}
+
+float MapGenerator::GetDefaultDensity(MapPattern pattern)
+{
+    return pattern == PATTERN_CAVES ? 0.45f : 0.3f;
+}
+
+const char* MapGenerator::GetPatternName(MapPattern pattern)
+{
+    switch (pattern)
+    {
+    case PATTERN_RANDOM: return "random";
+    case PATTERN_MAZE: return "maze";
+    case PATTERN_ROOMS: return "rooms";
+    case PATTERN_CAVES: return "caves";
+    default: return "unknown";
+    }
+}
+
+bool MapGenerator::ParsePattern(const std::string& name, MapPattern& pattern)
+{
+    for (int i = 0; i < PATTERN_COUNT; i++)
+    {
+        if (name == GetPatternName(static_cast<MapPattern>(i)))
+        {
+            pattern = static_cast<MapPattern>(i);
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,45 @@
+#ifndef MAPGENERATOR_H
+#define MAPGENERATOR_H
+
+#include <string>
+#include "Grid.h"
+
+// Procedural map patterns
+enum MapPattern {
+    PATTERN_RANDOM,     // Independent obstacles at the given density
+    PATTERN_MAZE,       // Perfect maze with one-tile corridors (recursive backtracker)
+    PATTERN_ROOMS,      // Rectangular rooms joined by L-shaped corridors
+    PATTERN_CAVES,      // Cellular-automaton caves, pockets filled so the floor is connected
+    PATTERN_COUNT
+};
+
+// Seeded map generators for large, reproducible test inputs. The same
+// pattern, size, seed and density always give the same map, whatever the
+// number of threads used to build it.
+//
+// Per-tile randomness is a hash of (seed, tile), and the maze is carved in
+// fixed-size regions with their own seeds, so the whole-map passes split
+// across threads on large maps. Room layout and region joins are small and
+// run serially.
+class MapGenerator
+{
+public:
+    // Keeps a typo on the command line from asking for an absurd allocation
+    static const int MAX_SIDE = 1 << 14;
+
+    // Resizes grid to width x depth and fills it. Start and goal go on the
+    // first and last walkable tiles in row order. Observers see a single change.
+    // density is the obstacle fraction for PATTERN_RANDOM and the initial
+    // fill for PATTERN_CAVES; the other patterns ignore it.
+    static bool Generate(Grid& grid, MapPattern pattern, int width, int depth,
+        unsigned int seed, float density, std::string& error);
+
+    // Density the pattern looks best at
+    static float GetDefaultDensity(MapPattern pattern);
+
+    // Lower-case names for the command line: random, maze, rooms, caves
+    static const char* GetPatternName(MapPattern pattern);
+    static bool ParsePattern(const std::string& name, MapPattern& pattern);
+};
+
+#endif
@@ -0,0 +1,124 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile()
+    : data(nullptr)
+    , size(0)
+    , opened(false)
+#ifdef _WIN32
+    , fileHandle(nullptr)
+    , mappingHandle(nullptr)
+#endif
+{
+}
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+bool MappedFile::Open(const std::string& path)
+{
+    Close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize))
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    fileHandle = file;
+    size = static_cast<size_t>(fileSize.QuadPart);
+    opened = true;
+
+    // Zero-length files cannot be mapped; treat them as open and empty
+    if (size == 0)
+        return true;
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr)
+    {
+        Close();
+        return false;
+    }
+    mappingHandle = mapping;
+
+    data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (data == nullptr)
+    {
+        Close();
+        return false;
+    }
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    size = static_cast<size_t>(info.st_size);
+    opened = true;
+    if (size == 0)
+    {
+        close(fd);
+        return true;
+    }
+
+    // The mapping stays valid after the descriptor is closed
+    void* view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (view == MAP_FAILED)
+    {
+        size = 0;
+        opened = false;
+        return false;
+    }
+    madvise(view, size, MADV_SEQUENTIAL);
+    data = static_cast<const char*>(view);
+#endif
+
+    return true;
+}
+
+void MappedFile::Close()
+{
+#ifdef _WIN32
+    if (data != nullptr)
+        UnmapViewOfFile(data);
+    if (mappingHandle != nullptr)
+        CloseHandle(mappingHandle);
+    if (fileHandle != nullptr)
+        CloseHandle(fileHandle);
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+#else
+    if (data != nullptr)
+        munmap(const_cast<char*>(data), size);
+#endif
+
+    data = nullptr;
+    size = 0;
+    opened = false;
+}
@@ -0,0 +1,38 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+
+// Read-only memory mapping of a whole file. The contents are paged in by the
+// OS on first touch, so large maps are parsed straight out of the page cache
+// without a copy through stream buffers.
+class MappedFile
+{
+public:
+    MappedFile();
+    ~MappedFile();
+
+    // Replaces any mapping already open; false if the file cannot be mapped
+    bool Open(const std::string& path);
+    void Close();
+
+    bool IsOpen() const { return opened; }
+    const char* GetData() const { return data; }
+    size_t GetSize() const { return size; }
+
+private:
+    const char* data;
+    size_t size;
+    bool opened;
+
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#endif
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+};
+
+#endif
@@ -0,0 +1,210 @@
+#include "MovingAI.h"
+#include "MappedFile.h"
+#include "MapGenerator.h"
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+    // Whitespace-separated tokens over a mapped, not null-terminated buffer
+    struct Cursor
+    {
+        const char* at;
+        const char* end;
+
+        void SkipBlanks()
+        {
+            while (at < end && (*at == ' ' || *at == '\t'))
+                at++;
+        }
+
+        void SkipWhitespace()
+        {
+            while (at < end && (*at == ' ' || *at == '\t' || *at == '\r' || *at == '\n'))
+                at++;
+        }
+
+        void SkipLine()
+        {
+            while (at < end && *at != '\n')
+                at++;
+            if (at < end)
+                at++;
+        }
+
+        bool AtEnd() const { return at >= end; }
+
+        std::string ReadToken()
+        {
+            SkipWhitespace();
+            const char* begin = at;
+            while (at < end && *at != ' ' && *at != '\t' && *at != '\r' && *at != '\n')
+                at++;
+            return std::string(begin, at);
+        }
+
+        bool ReadInt(int& value)
+        {
+            SkipWhitespace();
+            bool negative = at < end && *at == '-';
+            if (negative)
+                at++;
+            if (at >= end || *at < '0' || *at > '9')
+                return false;
+
+            long long result = 0;
+            while (at < end && *at >= '0' && *at <= '9' && result < 0x7fffffff)
+                result = result * 10 + (*at++ - '0');
+            value = static_cast<int>(negative ? -result : result);
+            return true;
+        }
+
+        bool ReadDouble(double& value)
+        {
+            std::string token = ReadToken();
+            if (token.empty())
+                return false;
+            char* parsed = nullptr;
+            value = std::strtod(token.c_str(), &parsed);
+            return parsed != token.c_str();
+        }
+    };
+
+    bool IsWalkableTerrain(char c)
+    {
+        // '.' and 'G' are ground, 'S' is swamp; trees, walls and water block
+        return c == '.' || c == 'G' || c == 'S';
+    }
+}
+
+bool MovingAI::LoadMap(const std::string& path, Grid& grid, std::string& error)
+{
+    MappedFile file;
+    if (!file.Open(path))
+    {
+        error = "cannot open " + path;
+        return false;
+    }
+
+    Cursor cursor = { file.GetData(), file.GetData() + file.GetSize() };
+    int width = -1, height = -1;
+
+    // Header lines in any order, ended by "map"
+    while (true)
+    {
+        std::string key = cursor.ReadToken();
+        if (key.empty())
+        {
+            error = path + ": missing 'map' line";
+            return false;
+        }
+        if (key == "map")
+            break;
+        if (key == "width" || key == "height")
+        {
+            int value;
+            if (!cursor.ReadInt(value) || value <= 0)
+            {
+                error = path + ": bad " + key;
+                return false;
+            }
+            (key == "width" ? width : height) = value;
+        }
+        cursor.SkipLine();
+    }
+    cursor.SkipLine();
+
+    if (width <= 0 || height <= 0)
+    {
+        error = path + ": missing width or height";
+        return false;
+    }
+    if (width > MapGenerator::MAX_SIDE || height > MapGenerator::MAX_SIDE)
+    {
+        error = path + ": size must be at most " + std::to_string(MapGenerator::MAX_SIDE);
+        return false;
+    }
+
+    // Check every row is present before Resize, so a short or corrupt file
+    // neither allocates for a map it does not hold nor wipes the current one
+    const char* rows = cursor.at;
+    if (cursor.end - cursor.at < static_cast<std::ptrdiff_t>(width) * height)
+    {
+        error = path + ": map is smaller than " + std::to_string(width) + "x" + std::to_string(height);
+        return false;
+    }
+    for (int z = 0; z < height; z++)
+    {
+        if (cursor.end - cursor.at < width)
+        {
+            error = path + ": map ends at row " + std::to_string(z);
+            return false;
+        }
+        cursor.at += width;
+        cursor.SkipLine();
+    }
+    cursor.at = rows;
+
+    grid.BeginBatch();
+    grid.Resize(width, height);
+
+    for (int z = 0; z < height; z++)
+    {
+        const char* row = cursor.at;
+        for (int x = 0; x < width; x++)
+        {
+            if (!IsWalkableTerrain(row[x]))
+                grid.SetTile(x, z, OBSTACLE);
+        }
+        cursor.at += width;
+        cursor.SkipLine();
+    }
+
+    grid.EndBatch();
+    return true;
+}
+
+bool MovingAI::LoadScenario(const std::string& path, std::vector<ScenarioEntry>& entries, std::string& error)
+{
+    MappedFile file;
+    if (!file.Open(path))
+    {
+        error = "cannot open " + path;
+        return false;
+    }
+
+    entries.clear();
+    Cursor cursor = { file.GetData(), file.GetData() + file.GetSize() };
+
+    // "version 1" or "version 1.0"; older files start straight with entries
+    cursor.SkipWhitespace();
+    if (cursor.end - cursor.at >= 7 && std::strncmp(cursor.at, "version", 7) == 0)
+        cursor.SkipLine();
+
+    while (true)
+    {
+        cursor.SkipWhitespace();
+        if (cursor.AtEnd())
+            break;
+
+        ScenarioEntry entry;
+        bool ok = cursor.ReadInt(entry.bucket);
+        entry.map = ok ? cursor.ReadToken() : std::string();
+        ok = ok && !entry.map.empty()
+            && cursor.ReadInt(entry.mapWidth) && cursor.ReadInt(entry.mapHeight)
+            && cursor.ReadInt(entry.startX) && cursor.ReadInt(entry.startZ)
+            && cursor.ReadInt(entry.goalX) && cursor.ReadInt(entry.goalZ)
+            && cursor.ReadDouble(entry.optimalLength);
+        if (!ok)
+        {
+            error = path + ": malformed entry " + std::to_string(entries.size() + 1);
+            return false;
+        }
+
+        entries.push_back(entry);
+        cursor.SkipLine();
+    }
+
+    return true;
+}
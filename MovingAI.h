@@ -0,0 +1,33 @@
+#ifndef MOVINGAI_H
+#define MOVINGAI_H
+
+#include <string>
+#include <vector>
+#include "Grid.h"
+
+// One query from a Moving AI .scen file. Map columns are x, rows are z.
+struct ScenarioEntry
+{
+    int bucket;
+    std::string map;
+    int mapWidth, mapHeight;
+    int startX, startZ;
+    int goalX, goalZ;
+    double optimalLength;   // Octile: straight steps 1, diagonal sqrt(2), no corner cutting
+};
+
+// Loaders for the Moving AI Lab grid benchmark formats (movingai.com/benchmarks).
+// Files are memory-mapped and parsed in place.
+class MovingAI
+{
+public:
+    // Resizes grid to the map's width x height and marks every cell that is
+    // not '.', 'G' or 'S' as OBSTACLE. Observers see a single change. A file
+    // that is truncated or larger than MapGenerator::MAX_SIDE on a side leaves
+    // grid as it was.
+    static bool LoadMap(const std::string& path, Grid& grid, std::string& error);
+
+    static bool LoadScenario(const std::string& path, std::vector<ScenarioEntry>& entries, std::string& error);
+};
+
+#endif
@@ -0,0 +1,89 @@
+#include "NodeHeap.h"
+
+void NodeHeap::Push(std::vector<Node>& nodes, CellId cell)
+{
+    heap.push_back(cell);
+    SiftUp(nodes, heap.size() - 1);
+}
+
+CellId NodeHeap::Pop(std::vector<Node>& nodes)
+{
+    CellId top = heap[0];
+    nodes[top].heapIndex = -1;
+
+    CellId last = heap.back();
+    heap.pop_back();
+
+    if (!heap.empty())
+    {
+        heap[0] = last;
+        SiftDown(nodes, 0);
+    }
+
+    return top;
+}
+
+void NodeHeap::DecreaseKey(std::vector<Node>& nodes, CellId cell)
+{
+    SiftUp(nodes, static_cast<size_t>(nodes[cell].heapIndex));
+}
+
+void NodeHeap::SiftUp(std::vector<Node>& nodes, size_t pos)
+{
+    CellId cell = heap[pos];
+    float key = nodes[cell].fCost;
+
+    // Move parents down until the hole reaches the right spot
+    while (pos > 0)
+    {
+        size_t parent = (pos - 1) / ARITY;
+        CellId parentCell = heap[parent];
+        if (nodes[parentCell].fCost <= key)
+            break;
+
+        heap[pos] = parentCell;
+        nodes[parentCell].heapIndex = static_cast<std::int64_t>(pos);
+        pos = parent;
+    }
+
+    heap[pos] = cell;
+    nodes[cell].heapIndex = static_cast<std::int64_t>(pos);
+}
+
+void NodeHeap::SiftDown(std::vector<Node>& nodes, size_t pos)
+{
+    CellId cell = heap[pos];
+    float key = nodes[cell].fCost;
+    size_t size = heap.size();
+
+    while (true)
+    {
+        size_t first = pos * ARITY + 1;
+        if (first >= size)
+            break;
+
+        // Pick the cheapest of up to ARITY children, which share a cache line
+        size_t last = first + ARITY < size ? first + ARITY : size;
+        size_t best = first;
+        float bestKey = nodes[heap[first]].fCost;
+        for (size_t child = first + 1; child < last; child++)
+        {
+            float childKey = nodes[heap[child]].fCost;
+            if (childKey < bestKey)
+            {
+                best = child;
+                bestKey = childKey;
+            }
+        }
+
+        if (bestKey >= key)
+            break;
+
+        heap[pos] = heap[best];
+        nodes[heap[pos]].heapIndex = static_cast<std::int64_t>(pos);
+        pos = best;
+    }
+
+    heap[pos] = cell;
+    nodes[cell].heapIndex = static_cast<std::int64_t>(pos);
+}
@@ -0,0 +1,60 @@
+#ifndef NODEHEAP_H
+#define NODEHEAP_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "Grid.h"
+
+// Per-search membership of a node
+enum NodeListState : unsigned char {
+    NODE_UNSEEN,
+    NODE_OPEN,
+    NODE_CLOSED
+};
+
+// Node for pathfinding, stored in a dense per-cell pool
+struct Node
+{
+    int x, z;
+    float gCost;
+    float hCost;
+    float fCost;
+    CellId parent;              // Cell id of the parent node, -1 for none
+    std::int64_t heapIndex;     // Position in the open list, -1 when not queued
+    unsigned int generation;    // Search that last wrote this node
+    NodeListState listState;    // Only meaningful when generation matches the search
+
+    Node() : x(0), z(0), gCost(0), hCost(0), fCost(0), parent(-1), heapIndex(-1), generation(0), listState(NODE_UNSEEN) {}
+};
+
+// Indexed 4-ary min-heap of cell ids ordered by fCost.
+// Each node remembers its heap position, so a cheaper path can be
+// re-sifted in place instead of pushing a duplicate entry.
+class NodeHeap
+{
+public:
+    static const int ARITY = 4;
+
+    void Clear() { heap.clear(); }
+    bool Empty() const { return heap.empty(); }
+    size_t Size() const { return heap.size(); }
+    void Reserve(size_t capacity) { heap.reserve(capacity); }
+
+    // Cell with the lowest fCost, or -1 when empty
+    CellId Top() const { return heap.empty() ? -1 : heap[0]; }
+
+    void Push(std::vector<Node>& nodes, CellId cell);
+    CellId Pop(std::vector<Node>& nodes);
+
+    // Restore heap order after nodes[cell].fCost was lowered
+    void DecreaseKey(std::vector<Node>& nodes, CellId cell);
+
+private:
+    std::vector<CellId> heap;
+
+    void SiftUp(std::vector<Node>& nodes, size_t pos);
+    void SiftDown(std::vector<Node>& nodes, size_t pos);
+};
+
+#endif
@@ -1,8 +1,48 @@
 #include "Pathfinding.h"
 #include <cmath>
 #include <algorithm>
+#include <limits>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
-Pathfinding::Pathfinding(Grid* grid)
+// Index of the lowest / highest set bit; word must be non-zero
+static int LowestBit(std::uint64_t word)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(word);
+#endif
+}
+
+static int HighestBit(std::uint64_t word)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanReverse64(&index, word);
+    return static_cast<int>(index);
+#else
+    return 63 - __builtin_clzll(word);
+#endif
+}
+
+// Cells of a side row that are open while the cell one step back is not:
+// exactly the forced-neighbor test of a horizontal JPS scan, for 64 cells at once.
+// previous is the side row's word the scan came from.
+static std::uint64_t ForcedBits(std::uint64_t side, std::uint64_t previous, int dx)
+{
+    std::uint64_t behind;
+    if (dx > 0)
+        behind = (side << 1) | (previous >> 63);
+    else
+        behind = (side >> 1) | (previous << 63);
+    return side & ~behind;
+}
+
+Pathfinding::Pathfinding(const Grid* grid)
     : grid(grid)
     , state(IDLE)
     , algorithm(ALGORITHM_DIJKSTRA)
@@ -13,56 +53,50 @@ Pathfinding::Pathfinding(Grid* grid)
     , executionTime(0.0f)
     , stepsPerSecond(20.0f)
     , timeSinceLastStep(0.0f)
+    , showJumpScans(false)
+    , heuristic(HEURISTIC_MANHATTAN)
+    , jumpTable(grid)
+    , hierarchy(grid)
+    , landmarks(grid, LANDMARK_COUNT)
 {
 }
 
 Pathfinding::~Pathfinding()
 {
-    CleanupNodes();
+    ClearSearch(search);
+    ClearSearch(solveSearch);
+    ClearSearch(reverseSearch);
+    ClearSearch(solveReverseSearch);
 }
 
 bool Pathfinding::StartDijkstra(int startX, int startZ, int goalX, int goalZ)
 {
-    Reset();
-
-    this->startX = startX;
-    this->startZ = startZ;
-    this->goalX = goalX;
-    this->goalZ = goalZ;
-    this->algorithm = ALGORITHM_DIJKSTRA;
-
-    // Initialize start node
-    Node* startNode = new Node(startX, startZ);
-    startNode->gCost = 0;
-    startNode->fCost = 0;
-
-    allNodes[GetKey(startX, startZ)] = startNode;
-    openSet.push(startNode);
-
-    state = RUNNING;
-    startTime = std::chrono::high_resolution_clock::now();
-
-    return true;
+    return StartSearch(ALGORITHM_DIJKSTRA, startX, startZ, goalX, goalZ);
 }
 
 bool Pathfinding::StartAStar(int startX, int startZ, int goalX, int goalZ)
 {
+    return StartSearch(ALGORITHM_ASTAR, startX, startZ, goalX, goalZ);
+}
+
+bool Pathfinding::StartSearch(AlgorithmType algorithm, int startX, int startZ, int goalX, int goalZ)
+{
+    if (!IsSupported(algorithm) || !IsValidQuery(startX, startZ, goalX, goalZ))
+        return false;
+
     Reset();
 
     this->startX = startX;
     this->startZ = startZ;
     this->goalX = goalX;
     this->goalZ = goalZ;
-    this->algorithm = ALGORITHM_ASTAR;
-
-    // Initialize start node
-    Node* startNode = new Node(startX, startZ);
-    startNode->gCost = 0;
-    startNode->hCost = Heuristic(startX, startZ, goalX, goalZ);
-    startNode->fCost = startNode->gCost + startNode->hCost;
+    this->algorithm = algorithm;
 
-    allNodes[GetKey(startX, startZ)] = startNode;
-    openSet.push(startNode);
+    search.recordScans = showJumpScans && algorithm == ALGORITHM_JPS;
+    if (IsBidirectional(algorithm))
+        BeginBidirectional(search, reverseSearch, startX, startZ, goalX, goalZ, algorithm, heuristic);
+    else if (algorithm != ALGORITHM_HPA)
+        BeginSearch(search, startX, startZ, goalX, goalZ, algorithm, heuristic);
 
     state = RUNNING;
     startTime = std::chrono::high_resolution_clock::now();
@@ -83,187 +117,759 @@ void Pathfinding::Update(float deltaTime)
     while (timeSinceLastStep >= stepInterval && state == RUNNING)
     {
         timeSinceLastStep -= stepInterval;
-
-        if (algorithm == ALGORITHM_DIJKSTRA)
-            StepDijkstra();
+        if (IsBidirectional(algorithm))
+            StepBidirectional();
+        else if (algorithm == ALGORITHM_HPA)
+            StepHierarchical();
         else
-            StepAStar();
+            Step();
     }
 }
 
-void Pathfinding::StepDijkstra()
+void Pathfinding::Step()
 {
-    if (openSet.empty())
+    Node* current = ExpandNext(search);
+    nodesExplored = search.nodesExplored;
+
+    if (current == nullptr)
     {
-        state = NO_PATH_FOUND;
-        auto endTime = std::chrono::high_resolution_clock::now();
-        executionTime = std::chrono::duration<float>(endTime - startTime).count();
+        FinishStep(NO_PATH_FOUND);
         return;
     }
 
-    // Get node with lowest cost
-    Node* current = openSet.top();
-    openSet.pop();
+    // Cells jumped over on the way to new jump points
+    for (CellId cell : search.scannedCells)
+        overlay.MarkIfEmpty(cell, SCANNED);
+    search.scannedCells.clear();
 
     // Mark as visited
-    TileState currentState = grid->GetTile(current->x, current->z);
-    if (currentState != START && currentState != GOAL)
-        grid->SetTile(current->x, current->z, VISITED);
-
-    nodesExplored++;
-    closedSet.push_back(current);
+    overlay.Mark(grid->GetCellId(current->x, current->z), VISITED);
 
     // Check if reached goal
     if (current->x == goalX && current->z == goalZ)
     {
-        ReconstructPath(current);
-        state = COMPLETED;
-        auto endTime = std::chrono::high_resolution_clock::now();
-        executionTime = std::chrono::duration<float>(endTime - startTime).count();
+        ReconstructPath(search, current);
+        FinishStep(COMPLETED);
+    }
+}
+
+void Pathfinding::StepBidirectional()
+{
+    bool backwardSide = false;
+    Node* current = ExpandNextBidirectional(search, reverseSearch, backwardSide);
+    nodesExplored = search.nodesExplored + reverseSearch.nodesExplored;
+
+    if (current == nullptr)
+    {
+        CellId meetCell = GetMeetingCell(search, reverseSearch);
+        if (meetCell < 0)
+        {
+            FinishStep(NO_PATH_FOUND);
+            return;
+        }
+
+        std::vector<PathCell> path;
+        CollectBidirectionalPath(search, reverseSearch, meetCell, path);
+        ShowPath(path);
+        FinishStep(COMPLETED);
         return;
     }
 
-    // Explore neighbors
-    std::vector<Node*> neighbors = GetNeighbors(current);
+    // Each frontier keeps its own color
+    overlay.Mark(grid->GetCellId(current->x, current->z), backwardSide ? VISITED_REVERSE : VISITED);
+}
 
-    for (Node* neighbor : neighbors)
+void Pathfinding::StepHierarchical()
+{
+    // The abstract graph is small enough to search in one step; show what it touched
+    std::vector<CellId> cells;
+    std::vector<CellId> expandedCells;
+    bool found = hierarchy.FindPath(startX, startZ, goalX, goalZ, cells, nodesExplored, &expandedCells);
+
+    for (CellId cell : expandedCells)
+        overlay.MarkIfEmpty(cell, VISITED);
+
+    if (!found)
     {
-        // Check if already in closed set
-        if (std::find(closedSet.begin(), closedSet.end(), neighbor) != closedSet.end())
-            continue;
+        FinishStep(NO_PATH_FOUND);
+        return;
+    }
 
-        float tentativeGCost = current->gCost + 1.0f;  // Assuming unit cost
+    std::vector<PathCell> path;
+    for (CellId cell : cells)
+        path.push_back({ grid->GetCellX(cell), grid->GetCellZ(cell) });
+    ShowPath(path);
+    FinishStep(COMPLETED);
+}
 
-        Node* existingNeighbor = GetNode(neighbor->x, neighbor->z);
+void Pathfinding::FinishStep(PathfindingState finalState)
+{
+    state = finalState;
+    auto endTime = std::chrono::high_resolution_clock::now();
+    executionTime = std::chrono::duration<float>(endTime - startTime).count();
+}
 
-        if (existingNeighbor == nullptr)
-        {
-            // New node
-            neighbor->gCost = tentativeGCost;
-            neighbor->fCost = neighbor->gCost;  // Dijkstra doesn't use heuristic
-            neighbor->parent = current;
+SolveResult Pathfinding::Solve(int startX, int startZ, int goalX, int goalZ, const SolveOptions& options)
+{
+    SolveResult result;
+    if (!IsSupported(options.algorithm))
+    {
+        result.supported = false;
+        return result;
+    }
+    if (!IsValidQuery(startX, startZ, goalX, goalZ))
+        return result;
 
-            allNodes[GetKey(neighbor->x, neighbor->z)] = neighbor;
-            openSet.push(neighbor);
-        }
-        else if (tentativeGCost < existingNeighbor->gCost)
-        {
-            // Better path found
-            existingNeighbor->gCost = tentativeGCost;
-            existingNeighbor->fCost = existingNeighbor->gCost;
-            existingNeighbor->parent = current;
+    auto solveStart = std::chrono::high_resolution_clock::now();
+
+    if (options.algorithm == ALGORITHM_HPA)
+    {
+        std::vector<CellId> cells;
+        result.found = hierarchy.FindPath(startX, startZ, goalX, goalZ, cells, result.nodesExplored);
+        for (CellId cell : cells)
+            result.path.push_back({ grid->GetCellX(cell), grid->GetCellZ(cell) });
+        result.pathLength = static_cast<int>(result.path.size());
+        result.pathCost = result.found ? static_cast<float>(result.pathLength - 1) : 0.0f;
+
+        auto solveEnd = std::chrono::high_resolution_clock::now();
+        result.executionTime = std::chrono::duration<float>(solveEnd - solveStart).count();
+
+        return result;
+    }
 
-            delete neighbor;  // We're using existing node
+    if (IsBidirectional(options.algorithm))
+    {
+        BeginBidirectional(solveSearch, solveReverseSearch, startX, startZ, goalX, goalZ, options.algorithm, options.heuristic);
+
+        bool backwardSide = false;
+        while (ExpandNextBidirectional(solveSearch, solveReverseSearch, backwardSide) != nullptr)
+        {
         }
-        else
+
+        result.nodesExplored = solveSearch.nodesExplored + solveReverseSearch.nodesExplored;
+
+        CellId meetCell = GetMeetingCell(solveSearch, solveReverseSearch);
+        if (meetCell >= 0)
         {
-            delete neighbor;  // Not needed
+            result.found = true;
+            result.pathCost = solveSearch.nodes[meetCell].gCost + solveReverseSearch.nodes[meetCell].gCost;
+            CollectBidirectionalPath(solveSearch, solveReverseSearch, meetCell, result.path);
+            result.pathLength = static_cast<int>(result.path.size());
         }
+
+        ClearSearch(solveSearch);
+        ClearSearch(solveReverseSearch);
+
+        auto solveEnd = std::chrono::high_resolution_clock::now();
+        result.executionTime = std::chrono::duration<float>(solveEnd - solveStart).count();
+
+        return result;
+    }
+
+    BeginSearch(solveSearch, startX, startZ, goalX, goalZ, options.algorithm, options.heuristic);
+
+    Node* current = nullptr;
+    while ((current = ExpandNext(solveSearch)) != nullptr)
+    {
+        if (current->x == goalX && current->z == goalZ)
+            break;
+    }
+
+    result.nodesExplored = solveSearch.nodesExplored;
+
+    if (current != nullptr)
+    {
+        result.found = true;
+        result.pathCost = current->gCost;
+        CollectPath(solveSearch, current, result.path);
+        result.pathLength = static_cast<int>(result.path.size());
     }
+
+    ClearSearch(solveSearch);
+
+    auto solveEnd = std::chrono::high_resolution_clock::now();
+    result.executionTime = std::chrono::duration<float>(solveEnd - solveStart).count();
+
+    return result;
 }
 
-void Pathfinding::StepAStar()
+void Pathfinding::BeginSearch(SearchState& search, int startX, int startZ, int goalX, int goalZ, AlgorithmType algorithm, HeuristicType heuristic)
 {
-    if (openSet.empty())
+    ClearSearch(search);
+
+    // Allocate the node pool once; later searches are isolated by the generation stamp
+    const size_t cellCount = static_cast<size_t>(grid->GetCellIdLimit());
+    if (search.nodes.size() != cellCount)
+        search.nodes.assign(cellCount, Node());
+
+    // JPS+ tables are built on first use and catch up with grid edits lazily
+    if (algorithm == ALGORITHM_JPS_PLUS)
+        jumpTable.Refresh();
+
+    // Landmark fields are refreshed lazily after grid edits
+    if (algorithm == ALGORITHM_ASTAR && heuristic == HEURISTIC_LANDMARKS)
+        landmarks.Refresh();
+
+    search.algorithm = algorithm;
+    search.heuristic = heuristic;
+    search.reversed = false;
+    search.goalX = goalX;
+    search.goalZ = goalZ;
+
+    // Initialize start node
+    CellId startIndex = GetCellIndex(startX, startZ);
+    Node* startNode = &search.nodes[startIndex];
+    startNode->x = startX;
+    startNode->z = startZ;
+    startNode->gCost = 0;
+    startNode->hCost = EstimateCost(search, startX, startZ);
+    startNode->fCost = startNode->gCost + startNode->hCost;
+    startNode->parent = -1;
+    startNode->generation = search.generation;
+    startNode->listState = NODE_OPEN;
+
+    // Keys pushed from the minimum are at most one step cost above it
+    if (algorithm == ALGORITHM_DIAL)
+        search.bucketOpen.Reset(grid->GetMaxCost());
+
+    PushOpen(search, startIndex);
+}
+
+Node* Pathfinding::ExpandNext(SearchState& search)
+{
+    // Get node with lowest cost
+    CellId currentIndex = PopOpen(search);
+    if (currentIndex < 0)
+        return nullptr;
+
+    Node* current = &search.nodes[currentIndex];
+
+    search.nodesExplored++;
+    current->listState = NODE_CLOSED;
+
+    // The goal is reported to the caller without expanding it
+    if (current->x == search.goalX && current->z == search.goalZ)
+        return current;
+
+    if (search.algorithm == ALGORITHM_JPS)
+        ExpandJumpPoints(search, currentIndex);
+    else if (search.algorithm == ALGORITHM_JPS_PLUS)
+        ExpandJumpPointsPlus(search, currentIndex);
+    else
+        ExpandGridNeighbors(search, currentIndex);
+
+    return current;
+}
+
+void Pathfinding::BeginBidirectional(SearchState& forward, SearchState& backward, int startX, int startZ, int goalX, int goalZ, AlgorithmType algorithm, HeuristicType heuristic)
+{
+    // Each half is an ordinary search aimed at the other end
+    AlgorithmType halfAlgorithm = algorithm == ALGORITHM_BIDIRECTIONAL_ASTAR ? ALGORITHM_ASTAR : ALGORITHM_DIJKSTRA;
+    BeginSearch(forward, startX, startZ, goalX, goalZ, halfAlgorithm, heuristic);
+    BeginSearch(backward, goalX, goalZ, startX, startZ, halfAlgorithm, heuristic);
+    backward.reversed = true;
+
+    forward.opposite = &backward;
+    backward.opposite = &forward;
+    forward.meetCost = std::numeric_limits<float>::infinity();
+    backward.meetCost = std::numeric_limits<float>::infinity();
+
+    // Neither half relaxes its own start, so a zero-length query has to meet up front
+    if (startX == goalX && startZ == goalZ)
     {
-        state = NO_PATH_FOUND;
-        auto endTime = std::chrono::high_resolution_clock::now();
-        executionTime = std::chrono::duration<float>(endTime - startTime).count();
-        return;
+        forward.meetCell = GetCellIndex(startX, startZ);
+        forward.meetCost = 0.0f;
     }
+}
 
-    // Get node with lowest fCost
-    Node* current = openSet.top();
-    openSet.pop();
+Node* Pathfinding::ExpandNextBidirectional(SearchState& forward, SearchState& backward, bool& backwardSide)
+{
+    // Either frontier running dry means every path through it has been seen
+    int forwardTop = forward.openSet.Top();
+    int backwardTop = backward.openSet.Top();
+    if (forwardTop < 0 || backwardTop < 0)
+        return nullptr;
+
+    // Stop once no unexpanded node can lead to anything cheaper than the best meeting.
+    // Dijkstra keys are distances, so the two frontier radii must add up to the best cost;
+    // A* keys already bound the whole path, so either frontier alone can prove it.
+    float bestCost = std::min(forward.meetCost, backward.meetCost);
+    float forwardKey = forward.nodes[forwardTop].fCost;
+    float backwardKey = backward.nodes[backwardTop].fCost;
+    if (forward.algorithm == ALGORITHM_ASTAR)
+    {
+        if (forwardKey >= bestCost || backwardKey >= bestCost)
+            return nullptr;
+    }
+    else if (forwardKey + backwardKey >= bestCost)
+    {
+        return nullptr;
+    }
 
-    // Mark as visited
-    TileState currentState = grid->GetTile(current->x, current->z);
-    if (currentState != START && currentState != GOAL)
-        grid->SetTile(current->x, current->z, VISITED);
+    // Grow the smaller frontier
+    backwardSide = backward.openSet.Size() < forward.openSet.Size();
+    return ExpandNext(backwardSide ? backward : forward);
+}
 
-    nodesExplored++;
-    closedSet.push_back(current);
+CellId Pathfinding::GetMeetingCell(const SearchState& forward, const SearchState& backward) const
+{
+    return forward.meetCost <= backward.meetCost ? forward.meetCell : backward.meetCell;
+}
 
-    // Check if reached goal
-    if (current->x == goalX && current->z == goalZ)
+void Pathfinding::ExpandGridNeighbors(SearchState& search, CellId currentIndex)
+{
+    const Node* current = &search.nodes[currentIndex];
+
+    // Explore neighbors
+    CellId neighbors[4];
+    int neighborCount = GetNeighbors(current, neighbors);
+
+    for (int i = 0; i < neighborCount; i++)
     {
-        ReconstructPath(current);
-        state = COMPLETED;
-        auto endTime = std::chrono::high_resolution_clock::now();
-        executionTime = std::chrono::duration<float>(endTime - startTime).count();
-        return;
+        int x = grid->GetCellX(neighbors[i]);
+        int z = grid->GetCellZ(neighbors[i]);
+
+        // A step costs the tile it enters. Walking an edge backwards enters
+        // the current tile, so the goal-side half charges that one; the two
+        // halves' costs then add up to the forward cost through the meeting cell.
+        float stepCost = search.reversed ? grid->GetCost(current->x, current->z) : grid->GetCost(x, z);
+        RelaxNode(search, currentIndex, neighbors[i], x, z, current->gCost + stepCost);
     }
+}
 
-    // Explore neighbors
-    std::vector<Node*> neighbors = GetNeighbors(current);
+void Pathfinding::ExpandJumpPoints(SearchState& search, CellId currentIndex)
+{
+    int x = search.nodes[currentIndex].x;
+    int z = search.nodes[currentIndex].z;
 
-    for (Node* neighbor : neighbors)
+    int dirX[8], dirZ[8];
+    int dirCount = GetJumpDirections(search, currentIndex, dirX, dirZ);
+
+    for (int i = 0; i < dirCount; i++)
     {
-        // Check if already in closed set
-        if (std::find(closedSet.begin(), closedSet.end(), neighbor) != closedSet.end())
+        CellId jumpCell = Jump(search, x, z, dirX[i], dirZ[i]);
+        if (jumpCell < 0)
             continue;
 
-        float tentativeGCost = current->gCost + 1.0f;
+        int jx = grid->GetCellX(jumpCell);
+        int jz = grid->GetCellZ(jumpCell);
+        float tentativeGCost = search.nodes[currentIndex].gCost + OctileDistance(x, z, jx, jz);
+        RelaxNode(search, currentIndex, jumpCell, jx, jz, tentativeGCost);
+    }
+}
 
-        Node* existingNeighbor = GetNode(neighbor->x, neighbor->z);
+void Pathfinding::ExpandJumpPointsPlus(SearchState& search, CellId currentIndex)
+{
+    int x = search.nodes[currentIndex].x;
+    int z = search.nodes[currentIndex].z;
+    int goalDX = search.goalX - x;
+    int goalDZ = search.goalZ - z;
 
-        if (existingNeighbor == nullptr)
+    int dirX[8], dirZ[8];
+    int dirCount = GetJumpDirections(search, currentIndex, dirX, dirZ);
+
+    for (int i = 0; i < dirCount; i++)
+    {
+        int dx = dirX[i];
+        int dz = dirZ[i];
+        int distance = jumpTable.GetDistance(x, z, JumpPointTable::GetDirection(dx, dz));
+        int reach = distance > 0 ? distance : -distance;
+        int steps = -1;
+
+        // The tables know nothing about the goal, so stop on it when a move passes it
+        if (dx == 0 || dz == 0)
         {
-            // New node
-            neighbor->gCost = tentativeGCost;
-            neighbor->hCost = Heuristic(neighbor->x, neighbor->z, goalX, goalZ);
-            neighbor->fCost = neighbor->gCost + neighbor->hCost;
-            neighbor->parent = current;
-
-            allNodes[GetKey(neighbor->x, neighbor->z)] = neighbor;
-            openSet.push(neighbor);
+            int along = dx != 0 ? goalDX * dx : goalDZ * dz;
+            int across = dx != 0 ? goalDZ : goalDX;
+            if (across == 0 && along > 0 && along <= reach)
+                steps = along;
         }
-        else if (tentativeGCost < existingNeighbor->gCost)
+        else if (goalDX * dx > 0 && goalDZ * dz > 0)
+        {
+            int minDiff = std::min(goalDX * dx, goalDZ * dz);
+            if (minDiff <= reach)
+                steps = minDiff;
+        }
+
+        if (steps < 0)
         {
-            // Better path found
-            existingNeighbor->gCost = tentativeGCost;
-            existingNeighbor->hCost = Heuristic(existingNeighbor->x, existingNeighbor->z, goalX, goalZ);
-            existingNeighbor->fCost = existingNeighbor->gCost + existingNeighbor->hCost;
-            existingNeighbor->parent = current;
+            if (distance <= 0)
+                continue;
+            steps = distance;
+        }
+
+        int jx = x + dx * steps;
+        int jz = z + dz * steps;
+        float tentativeGCost = search.nodes[currentIndex].gCost + OctileDistance(x, z, jx, jz);
+        RelaxNode(search, currentIndex, GetCellIndex(jx, jz), jx, jz, tentativeGCost);
+    }
+}
+
+int Pathfinding::GetJumpDirections(const SearchState& search, CellId currentIndex, int dirX[8], int dirZ[8]) const
+{
+    const Node* current = &search.nodes[currentIndex];
+    int x = current->x;
+    int z = current->z;
+
+    // Candidate directions; diagonals never cut a blocked corner
+    int dirCount = 0;
+
+    if (current->parent < 0)
+    {
+        // The start node looks in every direction
+        for (int dx = -1; dx <= 1; dx++)
+        {
+            for (int dz = -1; dz <= 1; dz++)
+            {
+                if (dx == 0 && dz == 0)
+                    continue;
+                if (dx != 0 && dz != 0 && (!IsWalkable(x + dx, z) || !IsWalkable(x, z + dz)))
+                    continue;
+                dirX[dirCount] = dx;
+                dirZ[dirCount] = dz;
+                dirCount++;
+            }
+        }
+    }
+    else
+    {
+        // Prune to the natural and forced neighbors of the travel direction
+        const Node* parent = &search.nodes[current->parent];
+        int dx = (x > parent->x) - (x < parent->x);
+        int dz = (z > parent->z) - (z < parent->z);
 
-            delete neighbor;
+        if (dx != 0 && dz != 0)
+        {
+            bool canX = IsWalkable(x + dx, z);
+            bool canZ = IsWalkable(x, z + dz);
+            if (canZ) { dirX[dirCount] = 0;  dirZ[dirCount] = dz; dirCount++; }
+            if (canX) { dirX[dirCount] = dx; dirZ[dirCount] = 0;  dirCount++; }
+            if (canX && canZ) { dirX[dirCount] = dx; dirZ[dirCount] = dz; dirCount++; }
+        }
+        else if (dx != 0)
+        {
+            bool canAhead = IsWalkable(x + dx, z);
+            bool canUp = IsWalkable(x, z + 1);
+            bool canDown = IsWalkable(x, z - 1);
+            if (canAhead)
+            {
+                dirX[dirCount] = dx; dirZ[dirCount] = 0; dirCount++;
+                if (canUp)   { dirX[dirCount] = dx; dirZ[dirCount] = 1;  dirCount++; }
+                if (canDown) { dirX[dirCount] = dx; dirZ[dirCount] = -1; dirCount++; }
+            }
+            if (canUp)   { dirX[dirCount] = 0; dirZ[dirCount] = 1;  dirCount++; }
+            if (canDown) { dirX[dirCount] = 0; dirZ[dirCount] = -1; dirCount++; }
         }
         else
         {
-            delete neighbor;
+            bool canAhead = IsWalkable(x, z + dz);
+            bool canRight = IsWalkable(x + 1, z);
+            bool canLeft = IsWalkable(x - 1, z);
+            if (canAhead)
+            {
+                dirX[dirCount] = 0; dirZ[dirCount] = dz; dirCount++;
+                if (canRight) { dirX[dirCount] = 1;  dirZ[dirCount] = dz; dirCount++; }
+                if (canLeft)  { dirX[dirCount] = -1; dirZ[dirCount] = dz; dirCount++; }
+            }
+            if (canRight) { dirX[dirCount] = 1;  dirZ[dirCount] = 0; dirCount++; }
+            if (canLeft)  { dirX[dirCount] = -1; dirZ[dirCount] = 0; dirCount++; }
         }
     }
+
+    return dirCount;
 }
 
-void Pathfinding::ReconstructPath(Node* endNode)
+CellId Pathfinding::Jump(SearchState& search, int x, int z, int dx, int dz) const
 {
-    pathLength = 0;
-    Node* current = endNode;
+    // Rows are contiguous in the bitboard; recorded scans still need every cell
+    if (dz == 0 && !search.recordScans)
+        return JumpRow(search, x, z, dx);
 
-    while (current != nullptr)
+    while (true)
     {
-        TileState state = grid->GetTile(current->x, current->z);
-        if (state != START && state != GOAL)
-            grid->SetTile(current->x, current->z, PATH);
+        // Diagonal steps need both orthogonal cells open
+        if (!IsWalkable(x + dx, z + dz))
+            return -1;
+        if (dx != 0 && dz != 0 && (!IsWalkable(x + dx, z) || !IsWalkable(x, z + dz)))
+            return -1;
+
+        x += dx;
+        z += dz;
 
-        pathLength++;
-        current = current->parent;
+        if (x == search.goalX && z == search.goalZ)
+            return GetCellIndex(x, z);
+
+        if (dx != 0 && dz != 0)
+        {
+            // A diagonal cell is a jump point when a straight scan from it finds one
+            if (Jump(search, x, z, dx, 0) >= 0 || Jump(search, x, z, 0, dz) >= 0)
+                return GetCellIndex(x, z);
+        }
+        else if (dx != 0)
+        {
+            // Forced neighbor: a side cell that was blocked one step back
+            if ((IsWalkable(x, z - 1) && !IsWalkable(x - dx, z - 1)) ||
+                (IsWalkable(x, z + 1) && !IsWalkable(x - dx, z + 1)))
+                return GetCellIndex(x, z);
+        }
+        else
+        {
+            if ((IsWalkable(x - 1, z) && !IsWalkable(x - 1, z - dz)) ||
+                (IsWalkable(x + 1, z) && !IsWalkable(x + 1, z - dz)))
+                return GetCellIndex(x, z);
+        }
+
+        if (search.recordScans)
+            search.scannedCells.push_back(GetCellIndex(x, z));
     }
 }
 
-float Pathfinding::Heuristic(int x1, int z1, int x2, int z2)
+CellId Pathfinding::JumpRow(const SearchState& search, int x, int z, int dx) const
+{
+    int width = grid->GetWidth();
+    int words = grid->GetWordsPerRow();
+    int first = x + dx;
+    if (first < 0 || first >= width)
+        return -1;
+
+    // The scan stops at the first blocked cell (no jump point), the goal, or a
+    // cell with a forced neighbor. Bits past the grid edge are clear, so the
+    // row end reads as blocked and missing side rows never force a stop.
+    for (int word = first >> 6; word >= 0 && word < words; word += dx)
+    {
+        std::uint64_t stops = ~grid->GetPassableWord(z, word)
+            | ForcedBits(grid->GetPassableWord(z - 1, word), grid->GetPassableWord(z - 1, word - dx), dx)
+            | ForcedBits(grid->GetPassableWord(z + 1, word), grid->GetPassableWord(z + 1, word - dx), dx);
+        if (search.goalZ == z && (search.goalX >> 6) == word)
+            stops |= std::uint64_t(1) << (search.goalX & 63);
+
+        // Ignore cells behind the scan start
+        if (word == first >> 6)
+        {
+            int bit = first & 63;
+            if (dx > 0)
+                stops &= ~std::uint64_t(0) << bit;
+            else
+                stops &= bit == 63 ? ~std::uint64_t(0) : (std::uint64_t(1) << (bit + 1)) - 1;
+        }
+
+        if (stops == 0)
+            continue;
+
+        int hitX = word * 64 + (dx > 0 ? LowestBit(stops) : HighestBit(stops));
+        if (!grid->IsPassable(hitX, z))
+            return -1;
+        return GetCellIndex(hitX, z);
+    }
+
+    return -1;
+}
+
+void Pathfinding::RelaxNode(SearchState& search, CellId parentIndex, CellId cell, int x, int z, float gCost)
+{
+    Node* node = &search.nodes[cell];
+    NodeListState listState = search.GetListState(*node);
+
+    // Check if already in closed set
+    if (listState == NODE_CLOSED)
+        return;
+
+    if (listState == NODE_UNSEEN)
+    {
+        // New node
+        node->x = x;
+        node->z = z;
+        node->gCost = gCost;
+        node->hCost = EstimateCost(search, x, z);
+        node->fCost = node->gCost + node->hCost;
+        node->parent = parentIndex;
+        node->generation = search.generation;
+        node->listState = NODE_OPEN;
+
+        PushOpen(search, cell);
+    }
+    else if (gCost < node->gCost)
+    {
+        // Better path found
+        node->gCost = gCost;
+        node->fCost = node->gCost + node->hCost;
+        node->parent = parentIndex;
+        DecreaseOpen(search, cell);
+    }
+    else
+    {
+        return;
+    }
+
+    // A cell both frontiers have reached joins the two halves into a full path
+    if (search.opposite != nullptr)
+    {
+        const Node& other = search.opposite->nodes[cell];
+        if (search.opposite->GetListState(other) != NODE_UNSEEN && node->gCost + other.gCost < search.meetCost)
+        {
+            search.meetCost = node->gCost + other.gCost;
+            search.meetCell = cell;
+        }
+    }
+}
+
+void Pathfinding::PushOpen(SearchState& search, CellId cell)
+{
+    if (search.algorithm == ALGORITHM_DIAL)
+        search.bucketOpen.Push(cell, static_cast<int>(search.nodes[cell].fCost));
+    else
+        search.openSet.Push(search.nodes, cell);
+}
+
+void Pathfinding::DecreaseOpen(SearchState& search, CellId cell)
+{
+    // The heap re-sifts in place; the bucket queue takes a duplicate that PopOpen skips later
+    if (search.algorithm == ALGORITHM_DIAL)
+        search.bucketOpen.Push(cell, static_cast<int>(search.nodes[cell].fCost));
+    else
+        search.openSet.DecreaseKey(search.nodes, cell);
+}
+
+CellId Pathfinding::PopOpen(SearchState& search)
+{
+    if (search.algorithm != ALGORITHM_DIAL)
+        return search.openSet.Empty() ? -1 : search.openSet.Pop(search.nodes);
+
+    while (!search.bucketOpen.Empty())
+    {
+        CellId cell = search.bucketOpen.Pop();
+        if (search.nodes[cell].listState != NODE_CLOSED)
+            return cell;
+    }
+    return -1;
+}
+
+void Pathfinding::ClearSearch(SearchState& search)
+{
+    // Invalidate every node at once; only a wrapped counter needs a real sweep
+    search.generation++;
+    if (search.generation == 0)
+    {
+        for (Node& node : search.nodes)
+            node.generation = 0;
+        search.generation = 1;
+    }
+
+    search.openSet.Clear();
+    search.bucketOpen.Clear();
+    search.scannedCells.clear();
+
+    search.nodesExplored = 0;
+    search.opposite = nullptr;
+    search.meetCell = -1;
+}
+
+void Pathfinding::ReconstructPath(const SearchState& search, const Node* endNode)
+{
+    std::vector<PathCell> path;
+    CollectPath(search, endNode, path);
+    ShowPath(path);
+}
+
+void Pathfinding::ShowPath(const std::vector<PathCell>& path)
+{
+    for (const PathCell& cell : path)
+        overlay.Mark(grid->GetCellId(cell.x, cell.z), PATH);
+
+    pathLength = static_cast<int>(path.size());
+}
+
+void Pathfinding::CollectPath(const SearchState& search, const Node* endNode, std::vector<PathCell>& path) const
+{
+    path.clear();
+    path.push_back({ endNode->x, endNode->z });
+
+    // Parents may be several cells away (JPS); fill in the straight or diagonal run between them
+    const Node* current = endNode;
+    while (current->parent >= 0)
+    {
+        const Node* parent = &search.nodes[current->parent];
+        int x = current->x;
+        int z = current->z;
+        int dx = (parent->x > x) - (parent->x < x);
+        int dz = (parent->z > z) - (parent->z < z);
+
+        while (x != parent->x || z != parent->z)
+        {
+            if (x != parent->x) x += dx;
+            if (z != parent->z) z += dz;
+            path.push_back({ x, z });
+        }
+
+        current = parent;
+    }
+
+    std::reverse(path.begin(), path.end());
+}
+
+void Pathfinding::CollectBidirectionalPath(const SearchState& forward, const SearchState& backward, CellId meetCell, std::vector<PathCell>& path) const
+{
+    // Start to meeting cell, then the goal-side chain walked back out to the goal
+    CollectPath(forward, &forward.nodes[meetCell], path);
+
+    std::vector<PathCell> goalSide;
+    CollectPath(backward, &backward.nodes[meetCell], goalSide);
+    for (int i = static_cast<int>(goalSide.size()) - 2; i >= 0; i--)
+        path.push_back(goalSide[i]);
+}
+
+float Pathfinding::EstimateCost(const SearchState& search, int x, int z) const
+{
+    switch (search.algorithm)
+    {
+    case ALGORITHM_ASTAR:
+        // Both bounds are admissible and consistent, so their maximum is too.
+        // They count steps and no step costs less than 1, so weighted tiles keep them so.
+        if (search.heuristic == HEURISTIC_LANDMARKS)
+            return std::max(landmarks.Estimate(GetCellIndex(x, z), GetCellIndex(search.goalX, search.goalZ)), Heuristic(x, z, search.goalX, search.goalZ));
+        return Heuristic(x, z, search.goalX, search.goalZ);
+    case ALGORITHM_JPS:
+    case ALGORITHM_JPS_PLUS:
+        return OctileDistance(x, z, search.goalX, search.goalZ);
+    default:              return 0.0f;  // Dijkstra variants
+    }
+}
+
+float Pathfinding::Heuristic(int x1, int z1, int x2, int z2) const
 {
     // Manhattan distance
     return static_cast<float>(abs(x1 - x2) + abs(z1 - z2));
 }
 
-std::vector<Node*> Pathfinding::GetNeighbors(Node* node)
+float Pathfinding::OctileDistance(int x1, int z1, int x2, int z2) const
 {
-    std::vector<Node*> neighbors;
+    // Exact cost on an open 8-connected grid: diagonal moves cost sqrt(2)
+    const float diagonalExtra = 0.41421356f;
+    int dx = abs(x1 - x2);
+    int dz = abs(z1 - z2);
+    return static_cast<float>(dx > dz ? dx : dz) + diagonalExtra * static_cast<float>(dx < dz ? dx : dz);
+}
+
+int Pathfinding::GetNeighbors(const Node* node, CellId neighbors[4]) const
+{
+    int count = 0;
 
     // 4-directional movement (up, down, left, right)
-    int dx[] = { 0, 0, -1, 1 };
-    int dz[] = { -1, 1, 0, 0 };
+    static const int dx[] = { 0, 0, -1, 1 };
+    static const int dz[] = { -1, 1, 0, 0 };
+
+    if (grid->GetLayout() == LAYOUT_PADDED)
+    {
+        // The OBSTACLE border stops every step off the map: plain offsets, no bounds checks
+        CellId cell = GetCellIndex(node->x, node->z);
+        for (int i = 0; i < 4; i++)
+        {
+            CellId next = cell + grid->GetCellStep(dx[i], dz[i]);
+            if (grid->IsPassableCell(next))
+                neighbors[count++] = next;
+        }
+        return count;
+    }
 
     for (int i = 0; i < 4; i++)
     {
@@ -271,27 +877,22 @@ std::vector<Node*> Pathfinding::GetNeighbors(Node* node)
         int newZ = node->z + dz[i];
 
         // Check bounds
-        if (newX < 0 || newX >= Grid::SIZE || newZ < 0 || newZ >= Grid::SIZE)
+        if (!grid->InBounds(newX, newZ))
             continue;
 
         // Check if obstacle
-        TileState state = grid->GetTile(newX, newZ);
-        if (state == OBSTACLE)
+        if (!grid->IsPassable(newX, newZ))
             continue;
 
-        neighbors.push_back(new Node(newX, newZ));
+        neighbors[count++] = GetCellIndex(newX, newZ);
     }
 
-    return neighbors;
+    return count;
 }
 
-Node* Pathfinding::GetNode(int x, int z)
+bool Pathfinding::IsWalkable(int x, int z) const
 {
-    int key = GetKey(x, z);
-    auto it = allNodes.find(key);
-    if (it != allNodes.end())
-        return it->second;
-    return nullptr;
+    return grid->IsPassable(x, z);
 }
 
 void Pathfinding::Pause()
@@ -313,12 +914,8 @@ void Pathfinding::Stop()
 
 void Pathfinding::Reset()
 {
-    CleanupNodes();
-
-    while (!openSet.empty())
-        openSet.pop();
-
-    closedSet.clear();
+    ClearSearch(search);
+    ClearSearch(reverseSearch);
 
     nodesExplored = 0;
     pathLength = 0;
@@ -326,28 +923,38 @@ void Pathfinding::Reset()
     timeSinceLastStep = 0.0f;
     state = IDLE;
 
-    // Clear visited and path tiles
-    for (int x = 0; x < Grid::SIZE; x++)
+    // Visited and path marks live in the overlay; dropping them is a generation bump
+    overlay.Fit(*grid);
+    overlay.Clear();
+}
+
+const char* Pathfinding::GetAlgorithmName(AlgorithmType algorithm)
+{
+    switch (algorithm)
     {
-        for (int z = 0; z < Grid::SIZE; z++)
-        {
-            TileState tileState = grid->GetTile(x, z);
-            if (tileState == VISITED || tileState == PATH)
-                grid->SetTile(x, z, EMPTY);
-        }
+    case ALGORITHM_DIJKSTRA: return "Dijkstra";
+    case ALGORITHM_ASTAR:    return "A*";
+    case ALGORITHM_DIAL:     return "Dijkstra (Bucket Queue)";
+    case ALGORITHM_JPS:      return "Jump Point Search";
+    case ALGORITHM_JPS_PLUS: return "JPS+ (Precomputed)";
+    case ALGORITHM_BIDIRECTIONAL_DIJKSTRA: return "Bidirectional Dijkstra";
+    case ALGORITHM_BIDIRECTIONAL_ASTAR:    return "Bidirectional A*";
+    case ALGORITHM_HPA:      return "HPA* (Hierarchical)";
+    default:                 return "Unknown";
     }
 }
 
-void Pathfinding::SetSpeed(float stepsPerSecond)
+bool Pathfinding::IsBidirectional(AlgorithmType algorithm)
 {
-    this->stepsPerSecond = stepsPerSecond;
+    return algorithm == ALGORITHM_BIDIRECTIONAL_DIJKSTRA || algorithm == ALGORITHM_BIDIRECTIONAL_ASTAR;
 }
 
-void Pathfinding::CleanupNodes()
+bool Pathfinding::SupportsCosts(AlgorithmType algorithm)
 {
-    for (auto& pair : allNodes)
-    {
-        delete pair.second;
-    }
-    allNodes.clear();
-}
\ No newline at end of file
+    return algorithm != ALGORITHM_JPS && algorithm != ALGORITHM_JPS_PLUS && algorithm != ALGORITHM_HPA;
+}
+
+void Pathfinding::SetSpeed(float stepsPerSecond)
+{
+    this->stepsPerSecond = stepsPerSecond;
+}
@@ -2,31 +2,14 @@
 #define PATHFINDING_H
 
 #include <vector>
-#include <queue>
-#include <unordered_map>
 #include <chrono>
 #include "Grid.h"
-
-// Node for pathfinding
-struct Node
-{
-    int x, z;
-    float gCost;
-    float hCost;
-    float fCost;
-    Node* parent;
-
-    Node(int x, int z) : x(x), z(z), gCost(0), hCost(0), fCost(0), parent(nullptr) {}
-};
-
-// Custom comparator for priority queue (min-heap based on fCost)
-struct NodeComparator
-{
-    bool operator()(const Node* a, const Node* b) const
-    {
-        return a->fCost > b->fCost;  // Greater than for min-heap
-    }
-};
+#include "NodeHeap.h"
+#include "BucketQueue.h"
+#include "JumpPointTable.h"
+#include "HierarchicalMap.h"
+#include "LandmarkTable.h"
+#include "SearchOverlay.h"
 
 // Pathfinding state
 enum PathfindingState {
@@ -40,20 +23,68 @@ enum PathfindingState {
 // Algorithm type
 enum AlgorithmType {
     ALGORITHM_DIJKSTRA,
-    ALGORITHM_ASTAR
+    ALGORITHM_ASTAR,
+    ALGORITHM_DIAL,     // Dijkstra over a bucket queue, integer costs only
+    ALGORITHM_JPS,      // Jump Point Search, 8-connected uniform cost
+    ALGORITHM_JPS_PLUS, // JPS over precomputed jump distances, uniform cost
+    ALGORITHM_BIDIRECTIONAL_DIJKSTRA,   // Frontiers grown from start and goal until they meet
+    ALGORITHM_BIDIRECTIONAL_ASTAR,
+    ALGORITHM_HPA       // Hierarchical A* over cached cluster graph, near-optimal, uniform cost
+};
+
+// Heuristic used by the A* variants
+enum HeuristicType {
+    HEURISTIC_MANHATTAN,
+    HEURISTIC_LANDMARKS     // ALT: triangle-inequality bounds from precomputed landmark distances
+};
+
+// Options for a headless Solve() query
+struct SolveOptions
+{
+    AlgorithmType algorithm;
+    HeuristicType heuristic;
+
+    SolveOptions() : algorithm(ALGORITHM_ASTAR), heuristic(HEURISTIC_MANHATTAN) {}
+};
+
+// Single cell along a solved path
+struct PathCell
+{
+    int x, z;
+};
+
+// Result of a headless Solve() query
+struct SolveResult
+{
+    bool found;
+    bool supported;     // False if the algorithm cannot search this grid (see Pathfinding::IsSupported)
+    std::vector<PathCell> path;     // Start to goal, both inclusive
+    int nodesExplored;
+    int pathLength;
+    float pathCost;
+    float executionTime;
+
+    SolveResult() : found(false), supported(true), nodesExplored(0), pathLength(0), pathCost(0.0f), executionTime(0.0f) {}
 };
 
 class Pathfinding
 {
 public:
-    Pathfinding(Grid* grid);
+    // The grid is only read; several Pathfinding instances can share one map
+    Pathfinding(const Grid* grid);
     ~Pathfinding();
 
+    // False, without starting, if the algorithm is not supported on this grid
+    // or either endpoint is off the grid or blocked
+    bool StartSearch(AlgorithmType algorithm, int startX, int startZ, int goalX, int goalZ);
     bool StartDijkstra(int startX, int startZ, int goalX, int goalZ);
     bool StartAStar(int startX, int startZ, int goalX, int goalZ);
 
     void Update(float deltaTime);
 
+    // Run a whole search synchronously without animating or touching the overlay
+    SolveResult Solve(int startX, int startZ, int goalX, int goalZ, const SolveOptions& options = SolveOptions());
+
     void Pause();
     void Resume();
     void Stop();
@@ -61,6 +92,17 @@ public:
 
     void SetSpeed(float stepsPerSecond);
 
+    // Paint the cells JPS scans between jump points as SCANNED while animating
+    void SetShowJumpScans(bool show) { showJumpScans = show; }
+    bool GetShowJumpScans() const { return showJumpScans; }
+
+    // Heuristic for animated A* searches; takes effect on the next start
+    void SetHeuristic(HeuristicType heuristic) { this->heuristic = heuristic; }
+    HeuristicType GetHeuristic() const { return heuristic; }
+
+    // Marks left by the animated search, to be drawn on top of the map
+    const SearchOverlay& GetOverlay() const { return overlay; }
+
     PathfindingState GetState() const { return state; }
     AlgorithmType GetAlgorithm() const { return algorithm; }
     int GetNodesExplored() const { return nodesExplored; }
@@ -68,15 +110,64 @@ public:
     float GetExecutionTime() const { return executionTime; }
     bool IsRunning() const { return state == RUNNING; }
 
+    static const char* GetAlgorithmName(AlgorithmType algorithm);
+    static bool IsBidirectional(AlgorithmType algorithm);
+
+    // Grid-neighbor searches charge the cost of the tile stepped onto. JPS,
+    // JPS+ and HPA* assume every step costs 1, so they refuse grids with
+    // weighted tiles rather than return wrong paths.
+    static bool SupportsCosts(AlgorithmType algorithm);
+    bool IsSupported(AlgorithmType algorithm) const { return SupportsCosts(algorithm) || grid->HasUniformCosts(); }
+    // Both endpoints in bounds and passable; searches index the node pool by them
+    bool IsValidQuery(int startX, int startZ, int goalX, int goalZ) const
+    {
+        return grid->IsPassable(startX, startZ) && grid->IsPassable(goalX, goalZ);
+    }
+
 private:
-    Grid* grid;
+    static const int LANDMARK_COUNT = 8;
+
+    // Open/closed bookkeeping for one search, shared by the animated and headless paths
+    struct SearchState
+    {
+        NodeHeap openSet;           // Dijkstra and A*
+        BucketQueue bucketOpen;     // Dial
+        std::vector<Node> nodes;    // Indexed by cell index, sized once per grid
+        unsigned int generation;    // Bumped per search so stale nodes read as unseen
+
+        AlgorithmType algorithm;
+        HeuristicType heuristic;
+        int goalX, goalZ;
+        int nodesExplored;
+
+        bool reversed;                  // Goal-side half of a bidirectional search: walks edges backwards
+        bool recordScans;               // Collect cells JPS scans, for visualization only
+        std::vector<CellId> scannedCells;
+
+        // Bidirectional only: the search growing from the other end, and the
+        // cheapest cell this side has reached that the other side has also seen
+        SearchState* opposite;
+        CellId meetCell;
+        float meetCost;
+
+        SearchState() : generation(1), algorithm(ALGORITHM_DIJKSTRA), heuristic(HEURISTIC_MANHATTAN), goalX(-1), goalZ(-1), nodesExplored(0), reversed(false), recordScans(false), opposite(nullptr), meetCell(-1), meetCost(0.0f) {}
+
+        NodeListState GetListState(const Node& node) const
+        {
+            return node.generation == generation ? node.listState : NODE_UNSEEN;
+        }
+    };
+
+    const Grid* grid;
+    SearchOverlay overlay;
     PathfindingState state;
     AlgorithmType algorithm;
 
-    // Algorithm state - FIXED COMPARATOR! 
-    std::priority_queue<Node*, std::vector<Node*>, NodeComparator> openSet;
-    std::unordered_map<int, Node*> allNodes;
-    std::vector<Node*> closedSet;
+    // Animated search state and scratch state reused by Solve()
+    SearchState search;
+    SearchState solveSearch;
+    SearchState reverseSearch;      // Goal-side halves of bidirectional searches
+    SearchState solveReverseSearch;
 
     int startX, startZ;
     int goalX, goalZ;
@@ -88,15 +179,46 @@ private:
 
     float stepsPerSecond;
     float timeSinceLastStep;
-
-    void StepDijkstra();
-    void StepAStar();
-    void ReconstructPath(Node* endNode);
-    float Heuristic(int x1, int z1, int x2, int z2);
-    std::vector<Node*> GetNeighbors(Node* node);
-    Node* GetNode(int x, int z);
-    int GetKey(int x, int z) { return x * 1000 + z; }
-    void CleanupNodes();
+    bool showJumpScans;
+    HeuristicType heuristic;
+
+    JumpPointTable jumpTable;
+    HierarchicalMap hierarchy;
+    LandmarkTable landmarks;
+
+    void Step();
+    void StepBidirectional();
+    void StepHierarchical();
+    void FinishStep(PathfindingState finalState);
+
+    void BeginSearch(SearchState& search, int startX, int startZ, int goalX, int goalZ, AlgorithmType algorithm, HeuristicType heuristic);
+    Node* ExpandNext(SearchState& search);
+    void BeginBidirectional(SearchState& forward, SearchState& backward, int startX, int startZ, int goalX, int goalZ, AlgorithmType algorithm, HeuristicType heuristic);
+    Node* ExpandNextBidirectional(SearchState& forward, SearchState& backward, bool& backwardSide);
+    CellId GetMeetingCell(const SearchState& forward, const SearchState& backward) const;
+    void ExpandGridNeighbors(SearchState& search, CellId currentIndex);
+    void ExpandJumpPoints(SearchState& search, CellId currentIndex);
+    void ExpandJumpPointsPlus(SearchState& search, CellId currentIndex);
+    int GetJumpDirections(const SearchState& search, CellId currentIndex, int dirX[8], int dirZ[8]) const;
+    CellId Jump(SearchState& search, int x, int z, int dx, int dz) const;
+    // Horizontal Jump() over the passability bitboard, 64 cells per step
+    CellId JumpRow(const SearchState& search, int x, int z, int dx) const;
+    void RelaxNode(SearchState& search, CellId parentIndex, CellId cell, int x, int z, float gCost);
+    void PushOpen(SearchState& search, CellId cell);
+    void DecreaseOpen(SearchState& search, CellId cell);
+    CellId PopOpen(SearchState& search);
+    void ClearSearch(SearchState& search);
+
+    void ReconstructPath(const SearchState& search, const Node* endNode);
+    void ShowPath(const std::vector<PathCell>& path);
+    void CollectPath(const SearchState& search, const Node* endNode, std::vector<PathCell>& path) const;
+    void CollectBidirectionalPath(const SearchState& forward, const SearchState& backward, CellId meetCell, std::vector<PathCell>& path) const;
+    float EstimateCost(const SearchState& search, int x, int z) const;
+    float Heuristic(int x1, int z1, int x2, int z2) const;
+    float OctileDistance(int x1, int z1, int x2, int z2) const;
+    int GetNeighbors(const Node* node, CellId neighbors[4]) const;
+    bool IsWalkable(int x, int z) const;
+    CellId GetCellIndex(int x, int z) const { return grid->GetCellId(x, z); }
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -1,6 +1,7 @@
 #include "Raycast.h"
 #include <algorithm>
 #include <cfloat>
+#include <cmath>
 
 glm::vec3 Raycast::GetMouseRay(double mouseX, double mouseY,
     int screenWidth, int screenHeight,
@@ -22,14 +23,15 @@ glm::vec3 Raycast::GetMouseRay(double mouseX, double mouseY,
     return glm::normalize(rayWorld);
 }
 
-bool Raycast::RayIntersectsTile(const glm::vec3& rayOrigin,
+bool Raycast::RayIntersectsTile(const Grid& grid,
+    const glm::vec3& rayOrigin,
     const glm::vec3& rayDir,
     int gridX, int gridZ,
     float& distance)
 {
     // Calculate tile bounds
-    float tileX = (float)gridX - Grid::SIZE / 2.0f + 0.5f;
-    float tileZ = (float)gridZ - Grid::SIZE / 2.0f + 0.5f;
+    float tileX = (float)gridX - grid.GetWidth() / 2.0f + 0.5f;
+    float tileZ = (float)gridZ - grid.GetDepth() / 2.0f + 0.5f;
 
     float minX = tileX - 0.45f, maxX = tileX + 0.45f;
     float minY = 0.0f, maxY = 0.15f;
@@ -61,7 +63,8 @@ bool Raycast::RayIntersectsTile(const glm::vec3& rayOrigin,
     return true;
 }
 
-bool Raycast::GetClickedTile(double mouseX, double mouseY,
+bool Raycast::GetClickedTile(const Grid& grid,
+    double mouseX, double mouseY,
     int screenWidth, int screenHeight,
     const glm::vec3& cameraPos,
     const glm::mat4& view,
@@ -70,15 +73,32 @@ bool Raycast::GetClickedTile(double mouseX, double mouseY,
 {
     glm::vec3 rayDir = GetMouseRay(mouseX, mouseY, screenWidth, screenHeight, view, projection);
 
+    // Tiles span 0 <= y <= 0.15, so a hit can only lie on the segment of the
+    // ray between those two planes
+    if (std::fabs(rayDir.y) < 1e-6f)
+        return false;
+
+    float tTop = std::max(0.0f, (0.15f - cameraPos.y) / rayDir.y);
+    float tGround = std::max(0.0f, (0.0f - cameraPos.y) / rayDir.y);
+    glm::vec3 a = cameraPos + rayDir * tTop;
+    glm::vec3 b = cameraPos + rayDir * tGround;
+
+    float halfWidth = grid.GetWidth() / 2.0f;
+    float halfDepth = grid.GetDepth() / 2.0f;
+    int startX = std::max(0, (int)std::floor(std::min(a.x, b.x) + halfWidth) - 1);
+    int endX = std::min(grid.GetWidth() - 1, (int)std::floor(std::max(a.x, b.x) + halfWidth) + 1);
+    int startZ = std::max(0, (int)std::floor(std::min(a.z, b.z) + halfDepth) - 1);
+    int endZ = std::min(grid.GetDepth() - 1, (int)std::floor(std::max(a.z, b.z) + halfDepth) + 1);
+
     float closestDist = FLT_MAX;
     int selectedX = -1, selectedZ = -1;
 
-    for (int x = 0; x < Grid::SIZE; x++)
+    for (int x = startX; x <= endX; x++)
     {
-        for (int z = 0; z < Grid::SIZE; z++)
+        for (int z = startZ; z <= endZ; z++)
         {
             float dist;
-            if (RayIntersectsTile(cameraPos, rayDir, x, z, dist))
+            if (RayIntersectsTile(grid, cameraPos, rayDir, x, z, dist))
             {
                 if (dist < closestDist)
                 {
@@ -98,4 +118,64 @@ bool Raycast::GetClickedTile(double mouseX, double mouseY,
     }
 
     return false;
-}
\ No newline at end of file
+}
+
+bool Raycast::GetVisibleTiles(const Grid& grid,
+    const glm::mat4& view,
+    const glm::mat4& projection,
+    int& minX, int& minZ, int& maxX, int& maxZ)
+{
+    // Frustum corners in world space; bit 0 picks x, bit 1 y and bit 2 depth in NDC
+    glm::mat4 inverse = glm::inverse(projection * view);
+    glm::vec3 corners[8];
+    for (int i = 0; i < 8; i++)
+    {
+        glm::vec4 corner = inverse * glm::vec4((i & 1) ? 1.0f : -1.0f,
+            (i & 2) ? 1.0f : -1.0f, (i & 4) ? 1.0f : -1.0f, 1.0f);
+        corners[i] = glm::vec3(corner.x / corner.w, corner.y / corner.w, corner.z / corner.w);
+    }
+
+    // The frustum is convex, so its part inside the slab is bounded by the
+    // corners within the slab and the points where its edges cross the slab
+    const float slabY[2] = { 0.0f, 0.15f };
+    float lowX = FLT_MAX, lowZ = FLT_MAX, highX = -FLT_MAX, highZ = -FLT_MAX;
+    auto include = [&](const glm::vec3& point)
+    {
+        lowX = std::min(lowX, point.x);
+        highX = std::max(highX, point.x);
+        lowZ = std::min(lowZ, point.z);
+        highZ = std::max(highZ, point.z);
+    };
+
+    for (int i = 0; i < 8; i++)
+    {
+        if (corners[i].y >= slabY[0] && corners[i].y <= slabY[1])
+            include(corners[i]);
+
+        // Edges join corners that differ in one bit
+        for (int bit = 1; bit < 8; bit <<= 1)
+        {
+            if (i & bit)
+                continue;
+            const glm::vec3& a = corners[i];
+            const glm::vec3& b = corners[i | bit];
+            for (float y : slabY)
+            {
+                if ((a.y - y) * (b.y - y) < 0.0f)
+                    include(a + (b - a) * ((y - a.y) / (b.y - a.y)));
+            }
+        }
+    }
+
+    if (lowX > highX)
+        return false;
+
+    // Tile x spans world x - width / 2 to x + 1 - width / 2, likewise for z
+    float halfWidth = grid.GetWidth() / 2.0f;
+    float halfDepth = grid.GetDepth() / 2.0f;
+    minX = std::max(0, (int)std::floor(lowX + halfWidth));
+    maxX = std::min(grid.GetWidth() - 1, (int)std::floor(highX + halfWidth));
+    minZ = std::max(0, (int)std::floor(lowZ + halfDepth));
+    maxZ = std::min(grid.GetDepth() - 1, (int)std::floor(highZ + halfDepth));
+    return minX <= maxX && minZ <= maxZ;
+}
@@ -14,18 +14,28 @@ public:
         const glm::mat4& projection);
 
     // Test ray intersection with tile
-    static bool RayIntersectsTile(const glm::vec3& rayOrigin,
+    static bool RayIntersectsTile(const Grid& grid,
+        const glm::vec3& rayOrigin,
         const glm::vec3& rayDir,
         int gridX, int gridZ,
         float& distance);
 
-    // Find which tile was clicked
-    static bool GetClickedTile(double mouseX, double mouseY,
+    // Find which tile was clicked. Only the tiles under the part of the ray
+    // between the tile tops and the ground plane are tested.
+    static bool GetClickedTile(const Grid& grid,
+        double mouseX, double mouseY,
         int screenWidth, int screenHeight,
         const glm::vec3& cameraPos,
         const glm::mat4& view,
         const glm::mat4& projection,
         int& outX, int& outZ);
+
+    // Tile range that can appear on screen: the bounds of the view frustum
+    // clipped to the tile slab, 0 <= y <= 0.15. False if no tile is in view.
+    static bool GetVisibleTiles(const Grid& grid,
+        const glm::mat4& view,
+        const glm::mat4& projection,
+        int& minX, int& minZ, int& maxX, int& maxZ);
 };
 
 #endif
@@ -0,0 +1,345 @@
+#include "RunLength.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace
+{
+    const char MAGIC[8] = { 'P', 'F', 'V', 'R', 'L', 'E', '1', '\0' };
+    const char COST_MAGIC[8] = { 'P', 'F', 'V', 'R', 'L', 'E', '2', '\0' };
+
+    // Sanity bound on decoded width * depth, so a corrupt header cannot ask
+    // for an absurd allocation. The area of the largest generated map
+    // (MapGenerator::MAX_SIDE squared), in any shape.
+    const std::uint64_t MAX_CELLS = std::uint64_t(1) << 28;
+
+    // Decoded runs, held until the whole stream has checked out. Only
+    // OBSTACLE runs and costs other than 1 are kept, so this grows with the
+    // stream rather than the map.
+    struct ObstacleRun
+    {
+        int z, x, length;
+        bool operator<(const ObstacleRun& other) const { return z != other.z ? z < other.z : x < other.x; }
+    };
+    struct CostRun
+    {
+        CellId tile, length;
+        unsigned char cost;
+    };
+
+    // Runs are in row order, so the one that could cover (x, z) is the last
+    // starting at or before it
+    bool IsBlocked(const std::vector<ObstacleRun>& runs, int x, int z)
+    {
+        auto next = std::upper_bound(runs.begin(), runs.end(), ObstacleRun{ z, x, 0 });
+        if (next == runs.begin())
+            return false;
+        const ObstacleRun& run = *(next - 1);
+        return run.z == z && x < run.x + run.length;
+    }
+
+    int LowestBit(std::uint64_t word)
+    {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward64(&index, word);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctzll(word);
+#endif
+    }
+
+    void PutVarint(std::string& buffer, std::uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            buffer.push_back(static_cast<char>((value & 0x7f) | 0x80));
+            value >>= 7;
+        }
+        buffer.push_back(static_cast<char>(value));
+    }
+
+    bool GetVarint(std::streambuf& in, std::uint64_t& value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            int byte = in.sbumpc();
+            if (byte == std::char_traits<char>::eof())
+                return false;
+            value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80))
+                return true;
+        }
+        return false;
+    }
+
+    // First cell at or after x in row z whose passability equals walkable,
+    // or width if there is none. Works a word at a time, so a long run costs
+    // one load per 64 cells.
+    int FindNext(const Grid& grid, int z, int x, bool walkable)
+    {
+        const int width = grid.GetWidth();
+        int word = x >> 6;
+        std::uint64_t bits = grid.GetPassableWord(z, word);
+        if (!walkable)
+            bits = ~bits;
+        bits &= ~std::uint64_t(0) << (x & 63);
+
+        while (!bits)
+        {
+            if (++word >= grid.GetWordsPerRow())
+                return width;
+            bits = grid.GetPassableWord(z, word);
+            if (!walkable)
+                bits = ~bits;
+        }
+
+        // Padding bits past the last column read as blocked; clamp them away
+        int found = word * 64 + LowestBit(bits);
+        return found < width ? found : width;
+    }
+}
+
+bool RunLength::Write(const Grid& grid, std::ostream& out, std::string& error)
+{
+    const int width = grid.GetWidth();
+    const int depth = grid.GetDepth();
+    const bool weighted = !grid.HasUniformCosts();
+
+    std::string buffer(weighted ? COST_MAGIC : MAGIC, sizeof(MAGIC));
+    PutVarint(buffer, static_cast<std::uint64_t>(width));
+    PutVarint(buffer, static_cast<std::uint64_t>(depth));
+
+    int x = -1, z = -1;
+    if (grid.HasStart())
+        grid.GetStart(x, z);
+    PutVarint(buffer, static_cast<std::uint64_t>(x + 1));
+    PutVarint(buffer, static_cast<std::uint64_t>(z + 1));
+    x = -1; z = -1;
+    if (grid.HasGoal())
+        grid.GetGoal(x, z);
+    PutVarint(buffer, static_cast<std::uint64_t>(x + 1));
+    PutVarint(buffer, static_cast<std::uint64_t>(z + 1));
+
+    for (int row = 0; row < depth; row++)
+    {
+        bool walkable = true;
+        for (int cell = 0; cell < width; walkable = !walkable)
+        {
+            int next = FindNext(grid, row, cell, !walkable);
+            PutVarint(buffer, static_cast<std::uint64_t>(next - cell));
+            cell = next;
+        }
+
+        // Flush in blocks so memory stays bounded on any map size
+        if (buffer.size() >= 64 * 1024 || row == depth - 1)
+        {
+            out.write(buffer.data(), buffer.size());
+            buffer.clear();
+        }
+    }
+    if (depth == 0)
+        out.write(buffer.data(), buffer.size());
+
+    // Costs follow as (run, cost) pairs over the tiles in row order
+    if (weighted)
+    {
+        buffer.clear();
+        std::uint64_t run = 0;
+        int runCost = 1;
+        for (int row = 0; row < depth; row++)
+        {
+            for (int cell = 0; cell < width; cell++)
+            {
+                int cost = grid.GetCost(cell, row);
+                if (cost != runCost && run > 0)
+                {
+                    PutVarint(buffer, run);
+                    PutVarint(buffer, static_cast<std::uint64_t>(runCost));
+                    run = 0;
+                }
+                runCost = cost;
+                run++;
+            }
+
+            if (buffer.size() >= 64 * 1024)
+            {
+                out.write(buffer.data(), buffer.size());
+                buffer.clear();
+            }
+        }
+        PutVarint(buffer, run);
+        PutVarint(buffer, static_cast<std::uint64_t>(runCost));
+        out.write(buffer.data(), buffer.size());
+    }
+
+    if (!out)
+    {
+        error = "write failed";
+        return false;
+    }
+    return true;
+}
+
+bool RunLength::Read(std::istream& in, Grid& grid, std::string& error)
+{
+    std::streambuf* source = in.rdbuf();
+    char magic[sizeof(MAGIC)];
+    if (!source || source->sgetn(magic, sizeof(magic)) != sizeof(magic) ||
+        (std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 && std::memcmp(magic, COST_MAGIC, sizeof(MAGIC)) != 0))
+    {
+        error = "not a run-length map";
+        return false;
+    }
+    const bool weighted = std::memcmp(magic, COST_MAGIC, sizeof(MAGIC)) == 0;
+
+    std::uint64_t header[6];
+    for (std::uint64_t& value : header)
+    {
+        if (!GetVarint(*source, value))
+        {
+            error = "truncated header";
+            return false;
+        }
+    }
+    if (header[0] == 0 || header[1] == 0 || header[0] > MAX_CELLS || header[1] > MAX_CELLS ||
+        header[0] * header[1] > MAX_CELLS)
+    {
+        error = "bad dimensions";
+        return false;
+    }
+
+    const int width = static_cast<int>(header[0]);
+    const int depth = static_cast<int>(header[1]);
+
+    // Decode and check everything before touching the grid, so a bad stream
+    // leaves the current map in place
+    std::vector<ObstacleRun> obstacles;
+    for (int z = 0; z < depth; z++)
+    {
+        bool walkable = true;
+        int x = 0;
+        while (x < width)
+        {
+            std::uint64_t run;
+            if (!GetVarint(*source, run) || run > static_cast<std::uint64_t>(width - x))
+            {
+                error = "bad run in row " + std::to_string(z);
+                return false;
+            }
+            if (!walkable && run > 0)
+                obstacles.push_back({ z, x, static_cast<int>(run) });
+            x += static_cast<int>(run);
+            walkable = !walkable;
+        }
+    }
+
+    // Cost runs cover every tile in row order; tiles left at 1 need no write
+    std::vector<CostRun> costs;
+    const CellId tileCount = static_cast<CellId>(width) * depth;
+    for (CellId tile = 0; weighted && tile < tileCount;)
+    {
+        std::uint64_t run, cost;
+        if (!GetVarint(*source, run) || !GetVarint(*source, cost) || run == 0 ||
+            run > static_cast<std::uint64_t>(tileCount - tile) || cost < 1 || cost > Grid::MAX_COST)
+        {
+            error = "bad cost run at tile " + std::to_string(tile);
+            return false;
+        }
+        if (cost != 1)
+            costs.push_back({ tile, static_cast<CellId>(run), static_cast<unsigned char>(cost) });
+        tile += static_cast<CellId>(run);
+    }
+
+    // Points are written one-based so zero can mean unset
+    const bool hasStart = header[2] || header[3];
+    const bool hasGoal = header[4] || header[5];
+    const int startX = static_cast<int>(header[2]) - 1, startZ = static_cast<int>(header[3]) - 1;
+    const int goalX = static_cast<int>(header[4]) - 1, goalZ = static_cast<int>(header[5]) - 1;
+    if (hasStart && (header[2] > header[0] || header[3] > header[1] || startX < 0 || startZ < 0 ||
+        IsBlocked(obstacles, startX, startZ)))
+    {
+        error = "start is outside the map or blocked";
+        return false;
+    }
+    if (hasGoal && (header[4] > header[0] || header[5] > header[1] || goalX < 0 || goalZ < 0 ||
+        IsBlocked(obstacles, goalX, goalZ)))
+    {
+        error = "goal is outside the map or blocked";
+        return false;
+    }
+
+    grid.BeginBatch();
+    grid.Resize(width, depth);
+    for (const ObstacleRun& run : obstacles)
+    {
+        for (int x = run.x; x < run.x + run.length; x++)
+            grid.SetTile(x, run.z, OBSTACLE);
+    }
+    for (const CostRun& run : costs)
+    {
+        for (CellId tile = run.tile; tile < run.tile + run.length; tile++)
+            grid.SetCost(static_cast<int>(tile % width), static_cast<int>(tile / width), run.cost);
+    }
+    if (hasStart)
+        grid.SetStart(startX, startZ);
+    if (hasGoal)
+        grid.SetGoal(goalX, goalZ);
+    grid.EndBatch();
+    return true;
+}
+
+bool RunLength::Save(const Grid& grid, const std::string& path, std::string& error)
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out)
+    {
+        error = "cannot write " + path;
+        return false;
+    }
+    if (!Write(grid, out, error))
+    {
+        error = path + ": " + error;
+        return false;
+    }
+    return true;
+}
+
+bool RunLength::Load(const std::string& path, Grid& grid, std::string& error)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+    {
+        error = "cannot open " + path;
+        return false;
+    }
+    if (!Read(in, grid, error))
+    {
+        error = path + ": " + error;
+        return false;
+    }
+    return true;
+}
+
+void GridSnapshot::Capture(const Grid& grid)
+{
+    std::ostringstream out(std::ios::binary);
+    std::string error;
+    RunLength::Write(grid, out, error);
+    data = out.str();
+}
+
+bool GridSnapshot::Restore(Grid& grid) const
+{
+    if (data.empty())
+        return false;
+    std::istringstream in(data, std::ios::binary);
+    std::string error;
+    return RunLength::Read(in, grid, error);
+}
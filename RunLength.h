@@ -0,0 +1,50 @@
+#ifndef RUNLENGTH_H
+#define RUNLENGTH_H
+
+#include <iosfwd>
+#include <string>
+#include "Grid.h"
+
+// Run-length coded maps. Obstacle maps are mostly long open runs broken by
+// walls, so a row costs a few bytes instead of one byte per tile.
+//
+// Stream layout, all integers as LEB128 varints:
+//   magic "PFVRLE1\0", or "PFVRLE2\0" when some tile costs more than 1
+//   width, depth, startX + 1, startZ + 1, goalX + 1, goalZ + 1 (0 when unset)
+//   depth rows, each a list of run lengths summing to width, alternating
+//   walkable and OBSTACLE and starting with walkable (which may be 0 long)
+//   PFVRLE2 only: (run length, cost) pairs covering every tile in row order,
+//   costs 1 to Grid::MAX_COST
+//
+// Rows are encoded and decoded one at a time straight to and from the stream,
+// and a stream ends exactly after its last row or cost run, so maps can be
+// sent over a pipe or socket back to back.
+class RunLength
+{
+public:
+    static bool Write(const Grid& grid, std::ostream& out, std::string& error);
+    // Resizes grid to the stream's dimensions. Observers see a single change.
+    // A stream that fails to decode leaves grid as it was.
+    static bool Read(std::istream& in, Grid& grid, std::string& error);
+
+    static bool Save(const Grid& grid, const std::string& path, std::string& error);
+    static bool Load(const std::string& path, Grid& grid, std::string& error);
+};
+
+// Compressed copy of a grid's map (obstacles, start and goal, costs), cheap
+// enough to keep several of for undo history even on large maps
+class GridSnapshot
+{
+public:
+    void Capture(const Grid& grid);
+    // Restores dimensions and contents; false if nothing was captured
+    bool Restore(Grid& grid) const;
+
+    bool IsEmpty() const { return data.empty(); }
+    size_t GetSize() const { return data.size(); }
+
+private:
+    std::string data;
+};
+
+#endif
@@ -0,0 +1,60 @@
+#include "SearchOverlay.h"
+#include <algorithm>
+
+SearchOverlay::SearchOverlay()
+    : generation(1)
+{
+}
+
+void SearchOverlay::Fit(const Grid& grid)
+{
+    size_t cellCount = static_cast<size_t>(grid.GetCellIdLimit());
+    if (stamps.size() == cellCount)
+        return;
+
+    stamps.assign(cellCount, 0);
+    marks.assign(cellCount, EMPTY);
+    generation = 1;
+}
+
+void SearchOverlay::Clear()
+{
+    generation++;
+
+    // On wrap-around old stamps could read as current again; wipe them once
+    if (generation == 0)
+    {
+        std::fill(stamps.begin(), stamps.end(), 0u);
+        generation = 1;
+    }
+}
+
+void SearchOverlay::Mark(CellId cell, TileState mark)
+{
+    if (cell < 0 || static_cast<size_t>(cell) >= stamps.size())
+        return;
+
+    stamps[cell] = generation;
+    marks[cell] = mark;
+}
+
+void SearchOverlay::MarkIfEmpty(CellId cell, TileState mark)
+{
+    if (GetMark(cell) == EMPTY)
+        Mark(cell, mark);
+}
+
+TileState SearchOverlay::GetMark(CellId cell) const
+{
+    if (cell < 0 || static_cast<size_t>(cell) >= stamps.size())
+        return EMPTY;
+    return stamps[cell] == generation ? marks[cell] : EMPTY;
+}
+
+TileState SearchOverlay::Compose(const Grid& grid, int x, int z) const
+{
+    TileState state = grid.GetTile(x, z);
+    if (state != EMPTY || !grid.InBounds(x, z))
+        return state;
+    return GetMark(grid.GetCellId(x, z));
+}
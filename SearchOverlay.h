@@ -0,0 +1,35 @@
+#ifndef SEARCHOVERLAY_H
+#define SEARCHOVERLAY_H
+
+#include <vector>
+#include "Grid.h"
+
+// Per-search marks (VISITED, VISITED_REVERSE, SCANNED, PATH) kept apart from
+// the map so searches never write into the Grid. Every mark carries the
+// generation it was written in; Clear() just bumps the generation, so
+// resetting costs O(1) no matter how large the map is.
+class SearchOverlay
+{
+public:
+    SearchOverlay();
+
+    // Match the overlay to the grid's cell count. Drops all marks if it changed.
+    void Fit(const Grid& grid);
+    void Clear();
+
+    void Mark(CellId cell, TileState mark);
+    // Leave cells that already carry a mark from this generation alone
+    void MarkIfEmpty(CellId cell, TileState mark);
+    TileState GetMark(CellId cell) const;
+
+    // Tile as drawn: start, goal and obstacles from the map win, otherwise
+    // this search's mark shows through
+    TileState Compose(const Grid& grid, int x, int z) const;
+
+private:
+    std::vector<unsigned int> stamps;
+    std::vector<TileState> marks;
+    unsigned int generation;
+};
+
+#endif
@@ -1,12 +1,28 @@
 ﻿#include "UI.h"
 #include "SutherlandHodgman.h"  
 #include <GLFW/glfw3.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 
 UI::UI()
     : currentMode(MODE_START)
+    , brushShape(BRUSH_TILE)
+    , brushRadius(2)
+    , paintCost(5)
     , clearGridRequested(false)
-    , runDijkstraRequested(false)
-    , runAStarRequested(false)
+    , saveMapRequested(false)
+    , loadMapRequested(false)
+    , undoRequested(false)
+    , redoRequested(false)
+    , generateMapRequested(false)
+    , generatePattern(PATTERN_MAZE)
+    , generateWidth(Grid::DEFAULT_SIZE + 1)
+    , generateDepth(Grid::DEFAULT_SIZE + 1)
+    , generateSeed(1)
+    , generateDensity(MapGenerator::GetDefaultDensity(PATTERN_MAZE))
+    , runAlgorithmRequested(false)
+    , requestedAlgorithm(ALGORITHM_DIJKSTRA)
     , pauseRequested(false)
     , resumeRequested(false)
     , stopRequested(false)
@@ -14,13 +30,19 @@ UI::UI()
     , gridHasStart(false)
     , gridHasGoal(false)
     , obstacleCount(0)
+    , weightedCount(0)
+    , canUndo(false)
+    , canRedo(false)
     , pathfindingState(IDLE)
     , currentAlgorithm(ALGORITHM_DIJKSTRA)
     , nodesExplored(0)
     , pathLength(0)
     , executionTime(0.0f)
     , speed(20.0f)
+    , showJumpScans(false)
+    , useLandmarks(false)
     , grid(nullptr)
+    , overlay(nullptr)
     , minimapSize(200.0f)
     , showMinimap(true)
     , controlPanelMinimized(false)
@@ -30,8 +52,9 @@ UI::UI()
     , shininess(32.0f)
     , minimapShape(SHAPE_RECTANGULAR)
     , zoomLevel(1.0f)
-    , zoomCenter(Grid::SIZE / 2.0f, Grid::SIZE / 2.0f)
+    , zoomCenter(Grid::DEFAULT_SIZE / 2.0f, Grid::DEFAULT_SIZE / 2.0f)
 {
+    std::strcpy(mapPath, "map.pfvmap");
 }
 
 UI::~UI()
@@ -94,6 +117,57 @@ void UI::RenderMinimap()
     }
 }
 
+TileState UI::GetMinimapTile(int x, int z) const
+{
+    return overlay ? overlay->Compose(*grid, x, z) : grid->GetTile(x, z);
+}
+
+int UI::DrawMinimapTiles(ImDrawList* drawList, ImVec2 canvasPos, float tileSize,
+    float originX, float originZ, int startX, int startZ, int endX, int endZ,
+    const glm::vec2* clipCenter, float clipRadius) const
+{
+    int step = glm::max(1, (int)std::ceil(MINIMAP_BLOCK_PIXELS / tileSize));
+    float inset = step == 1 ? 0.5f : 0.0f;
+
+    for (int x = startX; x < endX; x += step)
+    {
+        for (int z = startZ; z < endZ; z += step)
+        {
+            float px = canvasPos.x + (x - originX) * tileSize;
+            float py = canvasPos.y + (z - originZ) * tileSize;
+            float sizeX = glm::min(step, endX - x) * tileSize;
+            float sizeZ = glm::min(step, endZ - z) * tileSize;
+
+            // Quick distance check to skip blocks outside the circle
+            if (clipCenter != nullptr)
+            {
+                glm::vec2 blockCenter(px + sizeX / 2, py + sizeZ / 2);
+                if (glm::distance(blockCenter, *clipCenter) > clipRadius + step * tileSize)
+                    continue;
+            }
+
+            int sampleX = glm::min(x + step / 2, endX - 1);
+            int sampleZ = glm::min(z + step / 2, endZ - 1);
+            TileState state = GetMinimapTile(sampleX, sampleZ);
+            glm::vec3 color = grid->GetTileColor(state, grid->GetCost(sampleX, sampleZ));
+
+            ImU32 imColor = IM_COL32(
+                (int)(color.r * 255),
+                (int)(color.g * 255),
+                (int)(color.b * 255),
+                255
+            );
+
+            drawList->AddRectFilled(
+                ImVec2(px + inset, py + inset),
+                ImVec2(px + sizeX - inset, py + sizeZ - inset),
+                imColor
+            );
+        }
+    }
+    return step;
+}
+
 void UI::RenderMinimapRectangular()
 {
     ImGuiIO& io = ImGui::GetIO();
@@ -116,43 +190,26 @@ void UI::RenderMinimapRectangular()
         ImVec2(canvas_pos.x + canvas_size.x, canvas_pos.y + canvas_size.y),
         IM_COL32(20, 20, 25, 230));
 
-    // Draw tiles
-    float tileSize = canvas_size.x / Grid::SIZE;
-
-    for (int x = 0; x < Grid::SIZE; x++)
-    {
-        for (int z = 0; z < Grid::SIZE; z++)
-        {
-            TileState state = grid->GetTile(x, z);
-            glm::vec3 color = grid->GetTileColor(state);
+    // Draw tiles, scaled so the longer side of the grid fills the canvas
+    int width = grid->GetWidth();
+    int depth = grid->GetDepth();
+    float tileSize = canvas_size.x / glm::max(width, depth);
 
-            ImU32 imColor = IM_COL32(
-                (int)(color.r * 255),
-                (int)(color.g * 255),
-                (int)(color.b * 255),
-                255
-            );
-
-            float px = canvas_pos.x + x * tileSize;
-            float py = canvas_pos.y + z * tileSize;
-
-            draw_list->AddRectFilled(
-                ImVec2(px + 0.5f, py + 0.5f),
-                ImVec2(px + tileSize - 0.5f, py + tileSize - 0.5f),
-                imColor
-            );
-        }
-    }
+    int step = DrawMinimapTiles(draw_list, canvas_pos, tileSize, 0.0f, 0.0f, 0, 0, width, depth);
 
-    // Grid lines
-    for (int i = 0; i <= Grid::SIZE; i++)
+    // Grid lines, unless tiles are too small to see them
+    for (int i = 0; step == 1 && i <= width; i++)
     {
         float offset = i * tileSize;
         draw_list->AddLine(ImVec2(canvas_pos.x + offset, canvas_pos.y),
-            ImVec2(canvas_pos.x + offset, canvas_pos.y + canvas_size.y),
+            ImVec2(canvas_pos.x + offset, canvas_pos.y + depth * tileSize),
             IM_COL32(40, 40, 50, 180), 1.0f);
+    }
+    for (int i = 0; step == 1 && i <= depth; i++)
+    {
+        float offset = i * tileSize;
         draw_list->AddLine(ImVec2(canvas_pos.x, canvas_pos.y + offset),
-            ImVec2(canvas_pos.x + canvas_size.x, canvas_pos.y + offset),
+            ImVec2(canvas_pos.x + width * tileSize, canvas_pos.y + offset),
             IM_COL32(40, 40, 50, 180), 1.0f);
     }
 
@@ -196,57 +253,35 @@ void UI::RenderMinimapCircular()
         true
     );
 
-    float tileSize = canvas_size.x / Grid::SIZE;
+    int width = grid->GetWidth();
+    int depth = grid->GetDepth();
+    float tileSize = canvas_size.x / glm::max(width, depth);
 
     // Draw tiles (will be auto-clipped)
-    for (int x = 0; x < Grid::SIZE; x++)
-    {
-        for (int z = 0; z < Grid::SIZE; z++)
-        {
-            float px = canvas_pos.x + x * tileSize;
-            float py = canvas_pos.y + z * tileSize;
+    int step = DrawMinimapTiles(draw_list, canvas_pos, tileSize, 0.0f, 0.0f, 0, 0, width, depth, &center, radius);
 
-            // Quick distance check to skip far tiles
-            glm::vec2 tileCenter(px + tileSize / 2, py + tileSize / 2);
-            float dist = glm::distance(tileCenter, center);
-            if (dist > radius + tileSize)
-                continue;
-
-            TileState state = grid->GetTile(x, z);
-            glm::vec3 color = grid->GetTileColor(state);
-
-            ImU32 imColor = IM_COL32(
-                (int)(color.r * 255),
-                (int)(color.g * 255),
-                (int)(color.b * 255),
-                255
-            );
-
-            draw_list->AddRectFilled(
-                ImVec2(px + 0.5f, py + 0.5f),
-                ImVec2(px + tileSize - 0.5f, py + tileSize - 0.5f),
-                imColor
-            );
-        }
-    }
-
-    // Draw grid lines (will be auto-clipped to circle)
-    for (int i = 0; i <= Grid::SIZE; i++)
+    // Draw grid lines (will be auto-clipped to circle), unless tiles are too small to see them
+    for (int i = 0; step == 1 && i <= width; i++)
     {
         float offset = i * tileSize;
 
         // Vertical lines
         draw_list->AddLine(
             ImVec2(canvas_pos.x + offset, canvas_pos.y),
-            ImVec2(canvas_pos.x + offset, canvas_pos.y + canvas_size.y),
+            ImVec2(canvas_pos.x + offset, canvas_pos.y + depth * tileSize),
             IM_COL32(40, 40, 50, 180),
             1.0f
         );
+    }
+
+    for (int i = 0; step == 1 && i <= depth; i++)
+    {
+        float offset = i * tileSize;
 
         // Horizontal lines
         draw_list->AddLine(
             ImVec2(canvas_pos.x, canvas_pos.y + offset),
-            ImVec2(canvas_pos.x + canvas_size.x, canvas_pos.y + offset),
+            ImVec2(canvas_pos.x + width * tileSize, canvas_pos.y + offset),
             IM_COL32(40, 40, 50, 180),
             1.0f
         );
@@ -287,7 +322,9 @@ void UI::RenderMinimapZoomed()
         IM_COL32(20, 20, 25, 230));
 
     // Calculate zoom window in grid coordinates
-    float viewSize = Grid::SIZE / zoomLevel;
+    float gridWidth = (float)grid->GetWidth();
+    float gridDepth = (float)grid->GetDepth();
+    float viewSize = glm::max(gridWidth, gridDepth) / zoomLevel;
 
     float minX = zoomCenter.x - viewSize / 2;
     float maxX = zoomCenter.x + viewSize / 2;
@@ -296,9 +333,9 @@ void UI::RenderMinimapZoomed()
 
     // Clamp to grid bounds
     minX = glm::max(0.0f, minX);
-    maxX = glm::min((float)Grid::SIZE, maxX);
+    maxX = glm::min(gridWidth, maxX);
     minZ = glm::max(0.0f, minZ);
-    maxZ = glm::min((float)Grid::SIZE, maxZ);
+    maxZ = glm::min(gridDepth, maxZ);
 
     // Recalculate actual view size after clamping
     float actualViewSizeX = maxX - minX;
@@ -314,37 +351,14 @@ void UI::RenderMinimapZoomed()
     int endZ = (int)ceil(maxZ);
 
     startX = glm::max(0, startX);
-    endX = glm::min(Grid::SIZE, endX);
+    endX = glm::min(grid->GetWidth(), endX);
     startZ = glm::max(0, startZ);
-    endZ = glm::min(Grid::SIZE, endZ);
-
-    for (int x = startX; x < endX; x++)
-    {
-        for (int z = startZ; z < endZ; z++)
-        {
-            TileState state = grid->GetTile(x, z);
-            glm::vec3 color = grid->GetTileColor(state);
+    endZ = glm::min(grid->GetDepth(), endZ);
 
-            ImU32 imColor = IM_COL32(
-                (int)(color.r * 255),
-                (int)(color.g * 255),
-                (int)(color.b * 255),
-                255
-            );
-
-            float px = canvas_pos.x + (x - minX) * tileSize;
-            float py = canvas_pos.y + (z - minZ) * tileSize;
+    int step = DrawMinimapTiles(draw_list, canvas_pos, tileSize, minX, minZ, startX, startZ, endX, endZ);
 
-            draw_list->AddRectFilled(
-                ImVec2(px + 0.5f, py + 0.5f),
-                ImVec2(px + tileSize - 0.5f, py + tileSize - 0.5f),
-                imColor
-            );
-        }
-    }
-
-    // Draw grid lines
-    for (int i = startX; i <= endX; i++)
+    // Draw grid lines, unless tiles are too small to see them
+    for (int i = startX; step == 1 && i <= endX; i++)
     {
         float x = canvas_pos.x + (i - minX) * tileSize;
         draw_list->AddLine(
@@ -355,7 +369,7 @@ void UI::RenderMinimapZoomed()
         );
     }
 
-    for (int i = startZ; i <= endZ; i++)
+    for (int i = startZ; step == 1 && i <= endZ; i++)
     {
         float y = canvas_pos.y + (i - minZ) * tileSize;
         draw_list->AddLine(
@@ -454,6 +468,10 @@ void UI::RenderControlPanel()
         modeName = "CLEAR TILE";
         modeColor = ImVec4(0.8f, 0.8f, 0.2f, 1.0f);
         break;
+    case MODE_COST:
+        modeName = "PAINT COST";
+        modeColor = ImVec4(0.75f, 0.55f, 0.3f, 1.0f);
+        break;
     }
 
     ImGui::TextColored(modeColor, "%s", modeName);
@@ -476,11 +494,80 @@ void UI::RenderControlPanel()
     if (ImGui::Button("Clear Tile", ImVec2(-1, 30)))
         currentMode = MODE_CLEAR;
 
+    if (ImGui::Button("Paint Cost", ImVec2(-1, 30)))
+        currentMode = MODE_COST;
+    if (currentMode == MODE_COST)
+        ImGui::SliderInt("Cost", &paintCost, 1, Grid::MAX_COST);
+
+    // Brushes apply to obstacle, clear and cost modes; each stroke is one undo step
+    ImGui::Text("Brush:");
+    if (ImGui::RadioButton("Tile", brushShape == BRUSH_TILE))
+        brushShape = BRUSH_TILE;
+    ImGui::SameLine();
+    if (ImGui::RadioButton("Line", brushShape == BRUSH_LINE))
+        brushShape = BRUSH_LINE;
+    ImGui::SameLine();
+    if (ImGui::RadioButton("Rect", brushShape == BRUSH_RECT))
+        brushShape = BRUSH_RECT;
+    if (ImGui::RadioButton("Circle", brushShape == BRUSH_CIRCLE))
+        brushShape = BRUSH_CIRCLE;
+    ImGui::SameLine();
+    if (ImGui::RadioButton("Fill", brushShape == BRUSH_FILL))
+        brushShape = BRUSH_FILL;
+    if (brushShape == BRUSH_CIRCLE)
+        ImGui::SliderInt("Radius", &brushRadius, 1, 32);
+
     ImGui::Spacing();
 
     if (ImGui::Button("Clear Entire Grid", ImVec2(-1, 30)))
         clearGridRequested = true;
 
+    float halfWidth = (ImGui::GetContentRegionAvail().x - ImGui::GetStyle().ItemSpacing.x) * 0.5f;
+    ImGui::BeginDisabled(!canUndo);
+    if (ImGui::Button("Undo (Ctrl+Z)", ImVec2(halfWidth, 30)))
+        undoRequested = true;
+    ImGui::EndDisabled();
+    ImGui::SameLine();
+    ImGui::BeginDisabled(!canRedo);
+    if (ImGui::Button("Redo (Ctrl+Y)", ImVec2(halfWidth, 30)))
+        redoRequested = true;
+    ImGui::EndDisabled();
+
+    ImGui::Spacing();
+
+    // Binary map file, loaded by mapping it rather than parsing
+    ImGui::Text("Map File:");
+    ImGui::SetNextItemWidth(-1);
+    ImGui::InputText("##MapPath", mapPath, sizeof(mapPath));
+
+    if (ImGui::Button("Save Map", ImVec2(halfWidth, 30)))
+        saveMapRequested = true;
+    ImGui::SameLine();
+    if (ImGui::Button("Load Map", ImVec2(halfWidth, 30)))
+        loadMapRequested = true;
+
+    ImGui::Spacing();
+
+    // Seeded generators; the same settings always rebuild the same map
+    ImGui::Text("Generate Map:");
+    static const char* patternNames[] = { "Random", "Maze", "Rooms", "Caves" };
+    int pattern = generatePattern;
+    if (ImGui::Combo("Pattern", &pattern, patternNames, PATTERN_COUNT))
+    {
+        generatePattern = static_cast<MapPattern>(pattern);
+        generateDensity = MapGenerator::GetDefaultDensity(generatePattern);
+    }
+    ImGui::InputInt("Width", &generateWidth, 16, 256);
+    ImGui::InputInt("Depth", &generateDepth, 16, 256);
+    generateWidth = std::max(3, std::min(generateWidth, MapGenerator::MAX_SIDE));
+    generateDepth = std::max(3, std::min(generateDepth, MapGenerator::MAX_SIDE));
+    ImGui::InputInt("Seed", &generateSeed);
+    if (generatePattern == PATTERN_RANDOM || generatePattern == PATTERN_CAVES)
+        ImGui::SliderFloat("Density", &generateDensity, 0.0f, 1.0f, "%.2f");
+
+    if (ImGui::Button("Generate", ImVec2(-1, 30)))
+        generateMapRequested = true;
+
     ImGui::Separator();
     ImGui::Spacing();
 
@@ -488,7 +575,8 @@ void UI::RenderControlPanel()
     ImGui::Text("Grid Status:");
     ImGui::BulletText("Start: %s", gridHasStart ? "Set" : "Not Set");
     ImGui::BulletText("Goal: %s", gridHasGoal ? "Set" : "Not Set");
-    ImGui::BulletText("Obstacles: %d", obstacleCount);
+    ImGui::BulletText("Obstacles: %lld", static_cast<long long>(obstacleCount));
+    ImGui::BulletText("Weighted: %lld", static_cast<long long>(weightedCount));
 
     ImGui::Separator();
     ImGui::Spacing();
@@ -507,17 +595,30 @@ void UI::RenderControlPanel()
     if (!canRun)
         ImGui::PushStyleVar(ImGuiStyleVar_Alpha, 0.5f);
 
-    if (ImGui::Button("Run Dijkstra", ImVec2(-1, 35)))
-    {
-        if (canRun)
-            runDijkstraRequested = true;
-    }
-
-    if (ImGui::Button("Run A* Algorithm", ImVec2(-1, 35)))
+    struct AlgorithmButton { const char* label; AlgorithmType algorithm; };
+    static const AlgorithmButton algorithmButtons[] = {
+        { "Run Dijkstra", ALGORITHM_DIJKSTRA },
+        { "Run A* Algorithm", ALGORITHM_ASTAR },
+        { "Run Bidirectional Dijkstra", ALGORITHM_BIDIRECTIONAL_DIJKSTRA },
+        { "Run Bidirectional A*", ALGORITHM_BIDIRECTIONAL_ASTAR },
+        { "Run Dijkstra (Bucket Queue)", ALGORITHM_DIAL },
+        { "Run Jump Point Search (8-way)", ALGORITHM_JPS },
+        { "Run JPS+ (8-way, precomputed)", ALGORITHM_JPS_PLUS },
+        { "Run HPA* (Hierarchical)", ALGORITHM_HPA }
+    };
+
+    for (const AlgorithmButton& button : algorithmButtons)
     {
-        if (canRun)
-            runAStarRequested = true;
+        ImGui::BeginDisabled(weightedCount > 0 && !Pathfinding::SupportsCosts(button.algorithm));
+        if (ImGui::Button(button.label, ImVec2(-1, 35)) && canRun)
+        {
+            runAlgorithmRequested = true;
+            requestedAlgorithm = button.algorithm;
+        }
+        ImGui::EndDisabled();
     }
+    if (weightedCount > 0)
+        ImGui::TextDisabled("JPS, JPS+ and HPA* need uniform costs");
 
     if (!canRun)
     {
@@ -555,6 +656,8 @@ void UI::RenderControlPanel()
     // Speed control
     ImGui::Text("Animation Speed:");
     ImGui::SliderFloat("Steps/sec", &speed, 1.0f, 100.0f, "%.0f");
+    ImGui::Checkbox("Show JPS scanned cells", &showJumpScans);
+    ImGui::Checkbox("A*: landmark (ALT) heuristic", &useLandmarks);
 
     ImGui::Separator();
     ImGui::Spacing();
@@ -615,13 +718,15 @@ void UI::RenderControlPanel()
             ImGui::Separator();
             ImGui::Text("Zoom Controls:");
             ImGui::SliderFloat("Zoom Level", &zoomLevel, 1.0f, 5.0f, "%.1fx");
-            ImGui::SliderFloat("Center X", &zoomCenter.x, 0.0f, (float)Grid::SIZE, "%.1f");
-            ImGui::SliderFloat("Center Z", &zoomCenter.y, 0.0f, (float)Grid::SIZE, "%.1f");
+            float gridWidth = grid ? (float)grid->GetWidth() : (float)Grid::DEFAULT_SIZE;
+            float gridDepth = grid ? (float)grid->GetDepth() : (float)Grid::DEFAULT_SIZE;
+            ImGui::SliderFloat("Center X", &zoomCenter.x, 0.0f, gridWidth, "%.1f");
+            ImGui::SliderFloat("Center Z", &zoomCenter.y, 0.0f, gridDepth, "%.1f");
 
             if (ImGui::Button("Reset Zoom", ImVec2(-1, 25)))
             {
                 zoomLevel = 1.0f;
-                zoomCenter = glm::vec2(Grid::SIZE / 2.0f, Grid::SIZE / 2.0f);
+                zoomCenter = glm::vec2(gridWidth / 2.0f, gridDepth / 2.0f);
             }
         }
 
@@ -639,8 +744,7 @@ void UI::RenderControlPanel()
     // ===== STATISTICS ===== 
     ImGui::TextColored(ImVec4(1.0f, 0.8f, 0.2f, 1.0f), "Statistics:");
 
-    const char* algoName = (currentAlgorithm == ALGORITHM_DIJKSTRA) ? "Dijkstra" : "A*";
-    ImGui::BulletText("Algorithm: %s", algoName);
+    ImGui::BulletText("Algorithm: %s", Pathfinding::GetAlgorithmName(currentAlgorithm));
 
     const char* stateName = "Idle";
     ImVec4 stateColor = ImVec4(0.7f, 0.7f, 0.7f, 1.0f);
@@ -692,7 +796,8 @@ void UI::RenderControlPanel()
     ImGui::BulletText("TAB - Toggle cursor");
     ImGui::BulletText("W/A/S/D - Move camera");
     ImGui::BulletText("Scroll - Zoom");
-    ImGui::BulletText("Click tiles to edit");
+    ImGui::BulletText("Click or drag on tiles to edit");
+    ImGui::BulletText("Ctrl+Z / Ctrl+Y - Undo / Redo");
 
     ImGui::End();
 }
@@ -700,8 +805,12 @@ void UI::RenderControlPanel()
 void UI::ResetRequests()
 {
     clearGridRequested = false;
-    runDijkstraRequested = false;
-    runAStarRequested = false;
+    saveMapRequested = false;
+    loadMapRequested = false;
+    undoRequested = false;
+    redoRequested = false;
+    generateMapRequested = false;
+    runAlgorithmRequested = false;
     pauseRequested = false;
     resumeRequested = false;
     stopRequested = false;
@@ -712,11 +821,12 @@ void UI::SetStatus(const std::string& status)
     statusText = status;
 }
 
-void UI::SetGridStats(bool hasStart, bool hasGoal, int obstacleCount)
+void UI::SetGridStats(bool hasStart, bool hasGoal, CellId obstacleCount, CellId weightedCount)
 {
     gridHasStart = hasStart;
     gridHasGoal = hasGoal;
     this->obstacleCount = obstacleCount;
+    this->weightedCount = weightedCount;
 }
 
 void UI::SetPathfindingState(PathfindingState state, AlgorithmType algorithm,
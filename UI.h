@@ -7,6 +7,7 @@
 #include "H:\CE\III-II\III-II\COMP 342\Project\PathfindingVisualizer\libs\imgui\imgui-1.92.2b\backends\imgui_impl_opengl3.h"
 #include "Grid.h"
 #include "Pathfinding.h"  
+#include "MapGenerator.h"
 
 class UI
 {
@@ -22,25 +23,43 @@ public:
 
     // Get current state
     EditMode GetCurrentMode() const { return currentMode; }
+    BrushShape GetBrushShape() const { return brushShape; }
+    int GetBrushRadius() const { return brushRadius; }
+    unsigned char GetPaintCost() const { return static_cast<unsigned char>(paintCost); }
     bool ShouldClearGrid() const { return clearGridRequested; }
-    bool ShouldRunDijkstra() const { return runDijkstraRequested; }
-    bool ShouldRunAStar() const { return runAStarRequested; }
+    bool ShouldSaveMap() const { return saveMapRequested; }
+    bool ShouldLoadMap() const { return loadMapRequested; }
+    bool ShouldUndo() const { return undoRequested; }
+    bool ShouldRedo() const { return redoRequested; }
+    std::string GetMapPath() const { return mapPath; }
+    bool ShouldGenerateMap() const { return generateMapRequested; }
+    MapPattern GetGeneratePattern() const { return generatePattern; }
+    int GetGenerateWidth() const { return generateWidth; }
+    int GetGenerateDepth() const { return generateDepth; }
+    unsigned int GetGenerateSeed() const { return static_cast<unsigned int>(generateSeed); }
+    float GetGenerateDensity() const { return generateDensity; }
+    bool ShouldRunAlgorithm() const { return runAlgorithmRequested; }
+    AlgorithmType GetRequestedAlgorithm() const { return requestedAlgorithm; }
     bool ShouldPause() const { return pauseRequested; }
     bool ShouldResume() const { return resumeRequested; }
     bool ShouldStop() const { return stopRequested; }
     float GetSpeed() const { return speed; }
+    bool GetShowJumpScans() const { return showJumpScans; }
+    bool GetUseLandmarks() const { return useLandmarks; }
 
     // Reset request flags
     void ResetRequests();
 
     // Update status
     void SetStatus(const std::string& status);
-    void SetGridStats(bool hasStart, bool hasGoal, int obstacleCount);
+    void SetGridStats(bool hasStart, bool hasGoal, CellId obstacleCount, CellId weightedCount);
+    void SetHistory(bool canUndo, bool canRedo) { this->canUndo = canUndo; this->canRedo = canRedo; }
     void SetPathfindingState(PathfindingState state, AlgorithmType algorithm,
         int nodesExplored, int pathLength, float executionTime);
 
     // Minimap
     void SetGrid(Grid* grid) { this->grid = grid; }  
+    void SetOverlay(const SearchOverlay* overlay) { this->overlay = overlay; }
 
     glm::vec3 GetLightPosition() const { return lightPosition; }
     float GetAmbientStrength() const { return ambientStrength; }
@@ -51,14 +70,38 @@ private:
     void RenderMinimap(); 
     void RenderMinimapRectangular(); 
     void RenderMinimapCircular();     
-    void RenderMinimapZoomed();      
+    void RenderMinimapZoomed();
+    TileState GetMinimapTile(int x, int z) const;      
+    // Draws tiles [startX, endX) x [startZ, endZ), tile (originX, originZ) at
+    // canvasPos. Below MINIMAP_BLOCK_PIXELS per tile, square blocks of tiles are
+    // drawn in their center tile's color, so big maps cost no more than the
+    // canvas has pixels. Returns the block side in tiles. clipCenter, if given,
+    // skips blocks outside the circle.
+    int DrawMinimapTiles(ImDrawList* drawList, ImVec2 canvasPos, float tileSize,
+        float originX, float originZ, int startX, int startZ, int endX, int endZ,
+        const glm::vec2* clipCenter = nullptr, float clipRadius = 0.0f) const;
+    static const int MINIMAP_BLOCK_PIXELS = 2;
 
     void RenderControlPanel();
 
     EditMode currentMode;
+    BrushShape brushShape;
+    int brushRadius;
+    int paintCost;          // Cost mode: multiplier painted onto tiles
     bool clearGridRequested;
-    bool runDijkstraRequested;
-    bool runAStarRequested;
+    bool saveMapRequested;
+    bool loadMapRequested;
+    bool undoRequested;
+    bool redoRequested;
+    char mapPath[260];      // Binary map file for Save/Load
+    bool generateMapRequested;
+    MapPattern generatePattern;
+    int generateWidth;
+    int generateDepth;
+    int generateSeed;
+    float generateDensity;
+    bool runAlgorithmRequested;
+    AlgorithmType requestedAlgorithm;
     bool pauseRequested;
     bool resumeRequested;
     bool stopRequested;
@@ -69,7 +112,10 @@ private:
     std::string statusText;
     bool gridHasStart;
     bool gridHasGoal;
-    int obstacleCount;
+    CellId obstacleCount;
+    CellId weightedCount;   // Tiles costing more than 1; unit-cost engines are disabled while any exist
+    bool canUndo;
+    bool canRedo;
 
     // Pathfinding stats
     PathfindingState pathfindingState;
@@ -80,9 +126,12 @@ private:
 
     // Settings
     float speed;
+    bool showJumpScans;
+    bool useLandmarks;
 
     // Minimap
     Grid* grid; 
+    const SearchOverlay* overlay;     // Search marks drawn over the map, may be null
     float minimapSize; 
     bool showMinimap;  
     // NEW: Minimap clipping options
@@ -13,6 +13,18 @@
 #include "Raycast.h"
 #include "CreditWall.h"
 #include "UI.h"  
+#include "Benchmark.h"
+#include "MovingAI.h"
+#include "BinaryMap.h"
+#include "RunLength.h"
+#include "EditJournal.h"
+#include "MapGenerator.h"
+#include <string>
+#include <cstdlib>
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#endif
 
 // Window settings
 const unsigned int SCR_WIDTH = 1280;
@@ -28,6 +40,7 @@ Grid grid;
 UI ui;
 CreditWall* creditWall = nullptr;  // Pointer for proper initialization
 Pathfinding pathfinding(&grid);
+EditJournal journal(&grid);
 
 // Timing
 float deltaTime = 0.0f;
@@ -39,6 +52,12 @@ bool firstMouse = true;
 float lastX = SCR_WIDTH / 2.0f;
 float lastY = SCR_HEIGHT / 2.0f;
 
+// Obstacle, clear and cost strokes: one undo step from press to release. Line and
+// rectangle brushes span from the anchor (press) to the last tile dragged over.
+bool strokeActive = false;
+int strokeX = -1, strokeZ = -1;
+int anchorX = -1, anchorZ = -1;
+
 // Callbacks
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
 void mouse_callback(GLFWwindow* window, double xpos, double ypos);
@@ -46,8 +65,70 @@ void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
 void mouse_button_callback(GLFWwindow* window, int button, int action, int mods);
 void processInput(GLFWwindow* window);
 
-int main()
+// Tile under the mouse cursor, if any
+bool PickTile(GLFWwindow* window, int& x, int& z);
+// Applies the current edit mode to one tile
+void EditTile(int x, int z);
+// Paints the current brush shape at a tile; returns the number of cells changed
+CellId PaintBrush(int x, int z);
+void EndStroke();
+void UndoEdit(bool redo);
+
+// Line vertices (x, y, z triples) outlining every tile of the grid
+void BuildGridLines(const Grid& grid, std::vector<float>& vertices);
+
+// Map files by extension: .map (Moving AI, load only), .pfvrle (run-length),
+// anything else binary .pfvmap. "-" streams run-length maps over stdin/stdout.
+bool LoadMapFile(const std::string& path, Grid& grid, std::string& error);
+bool SaveMapFile(const Grid& grid, const std::string& path, std::string& error);
+
+// Arguments after --generate: <pattern> [--size N | --width N --depth N]
+// [--seed N] [--density F] [--out path]. outPath is empty without --out.
+bool GenerateMap(int argc, char** argv, Grid& grid, std::string& outPath, std::string& error);
+
+int main(int argc, char** argv)
 {
+    // Headless benchmark mode, runs without a window
+    if (argc > 1 && std::string(argv[1]) == "--benchmark")
+        return Benchmark::Run(argc - 2, argv + 2);
+
+    // Headless format conversion, e.g. to pipe a map into another process:
+    // --convert arena.map - | PathfindingVisualizer.exe --map -
+    if (argc == 4 && std::string(argv[1]) == "--convert")
+    {
+        std::string error;
+        if (!LoadMapFile(argv[2], grid, error) || !SaveMapFile(grid, argv[3], error))
+        {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    // Seeded map instead of an empty grid. With --out it is saved and the
+    // program exits, so a large input can be made once and reused:
+    // --generate caves --size 4096 --seed 7 --out caves.pfvmap
+    if (argc > 2 && std::string(argv[1]) == "--generate")
+    {
+        std::string error, outPath;
+        if (!GenerateMap(argc - 2, argv + 2, grid, outPath, error) ||
+            (!outPath.empty() && !SaveMapFile(grid, outPath, error)))
+        {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+        if (!outPath.empty())
+            return 0;
+    }
+
+    // Start from a map file instead of an empty grid
+    for (int i = 1; i + 1 < argc; i++)
+    {
+        std::string error;
+        if (std::string(argv[i]) == "--map" && !LoadMapFile(argv[i + 1], grid, error))
+            std::cerr << error << std::endl;
+    }
+
     // Startup message
     std::cout << "\n";
     std::cout << "================================================\n";
@@ -108,6 +189,7 @@ int main()
         return -1;
     }
     ui.SetGrid(&grid);
+    ui.SetOverlay(&pathfinding.GetOverlay());
 
     std::cout << "UI initialized successfully!" << std::endl;
 
@@ -124,14 +206,9 @@ int main()
 
     // Create grid lines
     std::vector<float> gridVertices;
-    for (int i = 0; i <= Grid::SIZE; i++)
-    {
-        float pos = (float)i - Grid::SIZE / 2.0f;
-        gridVertices.push_back(-Grid::SIZE / 2.0f); gridVertices.push_back(0.16f); gridVertices.push_back(pos);
-        gridVertices.push_back(Grid::SIZE / 2.0f); gridVertices.push_back(0.16f); gridVertices.push_back(pos);
-        gridVertices.push_back(pos); gridVertices.push_back(0.16f); gridVertices.push_back(-Grid::SIZE / 2.0f);
-        gridVertices.push_back(pos); gridVertices.push_back(0.16f); gridVertices.push_back(Grid::SIZE / 2.0f);
-    }
+    BuildGridLines(grid, gridVertices);
+    int lineWidth = grid.GetWidth(), lineDepth = grid.GetDepth();
+    std::uint64_t statsVersion = ~std::uint64_t(0);
 
     unsigned int gridVBO, gridVAO;
     glGenVertexArrays(1, &gridVAO);
@@ -226,34 +303,78 @@ int main()
 
         // Update speed from UI
         pathfinding.SetSpeed(ui.GetSpeed());
+        pathfinding.SetShowJumpScans(ui.GetShowJumpScans());
+        pathfinding.SetHeuristic(ui.GetUseLandmarks() ? HEURISTIC_LANDMARKS : HEURISTIC_MANHATTAN);
 
         // Handle UI requests
         if (ui.ShouldClearGrid())
         {
+            journal.BeginSnapshot();
             grid.ClearGrid();
+            journal.EndSnapshot();
             pathfinding.Reset();
             ui.SetStatus("Grid cleared");
             ui.ResetRequests();
         }
 
-        if (ui.ShouldRunDijkstra())
+        if (ui.ShouldSaveMap())
         {
-            // Hide credit wall when algorithm starts
-            if (creditWall && creditWall->IsVisible())
-            {
-                creditWall->Hide();
-            }
+            std::string error;
+            if (SaveMapFile(grid, ui.GetMapPath(), error))
+                ui.SetStatus("Map saved to " + ui.GetMapPath());
+            else
+                ui.SetStatus("Save failed: " + error);
+            ui.ResetRequests();
+        }
 
+        if (ui.ShouldLoadMap())
+        {
+            std::string error;
             pathfinding.Reset();
-            int sx, sz, gx, gz;
-            grid.GetStart(sx, sz);
-            grid.GetGoal(gx, gz);
-            pathfinding.StartDijkstra(sx, sz, gx, gz);
-            ui.SetStatus("Running Dijkstra...");
+            journal.BeginSnapshot();
+            if (LoadMapFile(ui.GetMapPath(), grid, error))
+                ui.SetStatus("Map loaded from " + ui.GetMapPath());
+            else
+                ui.SetStatus("Load failed: " + error);
+            journal.EndSnapshot();
             ui.ResetRequests();
         }
 
-        if (ui.ShouldRunAStar())
+        if (ui.ShouldGenerateMap())
+        {
+            std::string error;
+            pathfinding.Reset();
+            journal.BeginSnapshot();
+            if (MapGenerator::Generate(grid, ui.GetGeneratePattern(), ui.GetGenerateWidth(), ui.GetGenerateDepth(),
+                ui.GetGenerateSeed(), ui.GetGenerateDensity(), error))
+                ui.SetStatus(std::string("Generated ") + MapGenerator::GetPatternName(ui.GetGeneratePattern()) +
+                    " map, seed " + std::to_string(ui.GetGenerateSeed()));
+            else
+                ui.SetStatus("Generate failed: " + error);
+            journal.EndSnapshot();
+            ui.ResetRequests();
+        }
+
+        if (ui.ShouldUndo() || ui.ShouldRedo())
+        {
+            UndoEdit(ui.ShouldRedo());
+            ui.ResetRequests();
+        }
+
+        // Loads, and undoing them, can change the dimensions: grid lines are
+        // baked for the old ones and search state is sized for them
+        if (grid.GetWidth() != lineWidth || grid.GetDepth() != lineDepth)
+        {
+            lineWidth = grid.GetWidth();
+            lineDepth = grid.GetDepth();
+            pathfinding.Reset();
+            BuildGridLines(grid, gridVertices);
+            glBindBuffer(GL_ARRAY_BUFFER, gridVBO);
+            glBufferData(GL_ARRAY_BUFFER, gridVertices.size() * sizeof(float), gridVertices.data(), GL_STATIC_DRAW);
+        }
+        ui.SetHistory(journal.CanUndo(), journal.CanRedo());
+
+        if (ui.ShouldRunAlgorithm())
         {
             // Hide credit wall when algorithm starts
             if (creditWall && creditWall->IsVisible())
@@ -261,12 +382,18 @@ int main()
                 creditWall->Hide();
             }
 
+            AlgorithmType algorithm = ui.GetRequestedAlgorithm();
+
             pathfinding.Reset();
             int sx, sz, gx, gz;
             grid.GetStart(sx, sz);
             grid.GetGoal(gx, gz);
-            pathfinding.StartAStar(sx, sz, gx, gz);
-            ui.SetStatus("Running A*...");
+            if (pathfinding.StartSearch(algorithm, sx, sz, gx, gz))
+                ui.SetStatus(std::string("Running ") + Pathfinding::GetAlgorithmName(algorithm) + "...");
+            else if (!pathfinding.IsSupported(algorithm))
+                ui.SetStatus(std::string(Pathfinding::GetAlgorithmName(algorithm)) + " needs uniform costs");
+            else
+                ui.SetStatus("Start and goal must be on open tiles");
             ui.ResetRequests();
         }
 
@@ -311,14 +438,13 @@ int main()
             ui.SetStatus("No path exists!");
         }
 
-        // Update UI stats
-        int obstacleCount = 0;
-        for (int x = 0; x < Grid::SIZE; x++)
-            for (int z = 0; z < Grid::SIZE; z++)
-                if (grid.GetTile(x, z) == OBSTACLE)
-                    obstacleCount++;
-
-        ui.SetGridStats(grid.HasStart(), grid.HasGoal(), obstacleCount);
+        // Update UI stats; the grid keeps its counts, so only changes cost anything
+        if (grid.GetVersion() != statsVersion)
+        {
+            statsVersion = grid.GetVersion();
+            ui.SetGridStats(grid.HasStart(), grid.HasGoal(), grid.GetTileCount(OBSTACLE),
+                grid.GetCellCount() - grid.GetCostCount(1));
+        }
 
         // Render
         glClearColor(0.1f, 0.1f, 0.15f, 1.0f);
@@ -348,17 +474,20 @@ int main()
             creditWall->Render(shader);
         }
 
-        // Draw tiles
+        // Draw tiles; only those the camera can see, as large maps have millions
         glBindVertexArray(tileVAO);
-        for (int x = 0; x < Grid::SIZE; x++)
+        int minX, minZ, maxX, maxZ;
+        if (!Raycast::GetVisibleTiles(grid, view, projection, minX, minZ, maxX, maxZ))
+            maxX = minX - 1;
+        for (int x = minX; x <= maxX; x++)
         {
-            for (int z = 0; z < Grid::SIZE; z++)
+            for (int z = minZ; z <= maxZ; z++)
             {
                 glm::mat4 model = glm::mat4(1.0f);
                 model = glm::translate(model, grid.GetTileWorldPosition(x, z));
                 shader.SetMat4("model", glm::value_ptr(model));
 
-                glm::vec3 color = grid.GetTileColor(x, z);
+                glm::vec3 color = grid.GetTileColor(pathfinding.GetOverlay().Compose(grid, x, z), grid.GetCost(x, z));
                 shader.SetVec3("tileColor", color.r, color.g, color.b);
 
                 glDrawArrays(GL_TRIANGLES, 0, 36);
@@ -408,6 +537,21 @@ void processInput(GLFWwindow* window)
     }
     if (glfwGetKey(window, GLFW_KEY_TAB) == GLFW_RELEASE) keyTab = false;
 
+    // Undo with Ctrl+Z, redo with Ctrl+Y or Ctrl+Shift+Z; text fields keep their own
+    static bool keyUndo = false;
+    bool ctrl = glfwGetKey(window, GLFW_KEY_LEFT_CONTROL) == GLFW_PRESS ||
+        glfwGetKey(window, GLFW_KEY_RIGHT_CONTROL) == GLFW_PRESS;
+    bool shift = glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS ||
+        glfwGetKey(window, GLFW_KEY_RIGHT_SHIFT) == GLFW_PRESS;
+    bool z = glfwGetKey(window, GLFW_KEY_Z) == GLFW_PRESS;
+    bool y = glfwGetKey(window, GLFW_KEY_Y) == GLFW_PRESS;
+    if (ctrl && (z || y) && !keyUndo && !ImGui::GetIO().WantCaptureKeyboard)
+    {
+        keyUndo = true;
+        UndoEdit(y || shift);
+    }
+    if (!z && !y) keyUndo = false;
+
     // Camera movement
     if (!cursorEnabled)
     {
@@ -418,6 +562,105 @@ void processInput(GLFWwindow* window)
     }
 }
 
+void BuildGridLines(const Grid& grid, std::vector<float>& vertices)
+{
+    vertices.clear();
+    float halfWidth = grid.GetWidth() / 2.0f;
+    float halfDepth = grid.GetDepth() / 2.0f;
+    for (int i = 0; i <= grid.GetDepth(); i++)
+    {
+        float pos = (float)i - halfDepth;
+        vertices.push_back(-halfWidth); vertices.push_back(0.16f); vertices.push_back(pos);
+        vertices.push_back(halfWidth); vertices.push_back(0.16f); vertices.push_back(pos);
+    }
+    for (int i = 0; i <= grid.GetWidth(); i++)
+    {
+        float pos = (float)i - halfWidth;
+        vertices.push_back(pos); vertices.push_back(0.16f); vertices.push_back(-halfDepth);
+        vertices.push_back(pos); vertices.push_back(0.16f); vertices.push_back(halfDepth);
+    }
+}
+
+static std::string GetOption(int argc, char** argv, const char* name, const std::string& defaultValue)
+{
+    for (int i = 0; i + 1 < argc; i++)
+    {
+        if (std::string(argv[i]) == name)
+            return argv[i + 1];
+    }
+    return defaultValue;
+}
+
+bool GenerateMap(int argc, char** argv, Grid& grid, std::string& outPath, std::string& error)
+{
+    MapPattern pattern;
+    if (argc < 1 || !MapGenerator::ParsePattern(argv[0], pattern))
+    {
+        error = "Unknown pattern. Available: random, maze, rooms, caves";
+        return false;
+    }
+
+    std::string size = GetOption(argc, argv, "--size", "1024");
+    int width = std::atoi(GetOption(argc, argv, "--width", size).c_str());
+    int depth = std::atoi(GetOption(argc, argv, "--depth", size).c_str());
+    unsigned int seed = static_cast<unsigned int>(std::strtoul(GetOption(argc, argv, "--seed", "1").c_str(), nullptr, 10));
+    float density = MapGenerator::GetDefaultDensity(pattern);
+    std::string densityOption = GetOption(argc, argv, "--density", "");
+    if (!densityOption.empty())
+        density = static_cast<float>(std::atof(densityOption.c_str()));
+    outPath = GetOption(argc, argv, "--out", "");
+
+    return MapGenerator::Generate(grid, pattern, width, depth, seed, density, error);
+}
+
+static bool HasExtension(const std::string& path, const std::string& extension)
+{
+    return path.size() > extension.size() &&
+        path.compare(path.size() - extension.size(), extension.size(), extension) == 0;
+}
+
+bool LoadMapFile(const std::string& path, Grid& grid, std::string& error)
+{
+    if (path == "-")
+    {
+#ifdef _WIN32
+        _setmode(_fileno(stdin), _O_BINARY);
+#endif
+        if (!RunLength::Read(std::cin, grid, error))
+        {
+            error = "stdin: " + error;
+            return false;
+        }
+        return true;
+    }
+    if (HasExtension(path, ".map"))
+        return MovingAI::LoadMap(path, grid, error);
+    if (HasExtension(path, ".pfvrle"))
+        return RunLength::Load(path, grid, error);
+    return BinaryMap::Load(path, grid, error);
+}
+
+bool SaveMapFile(const Grid& grid, const std::string& path, std::string& error)
+{
+    if (path == "-")
+    {
+#ifdef _WIN32
+        _setmode(_fileno(stdout), _O_BINARY);
+#endif
+        bool written = RunLength::Write(grid, std::cout, error);
+        std::cout.flush();
+        return written;
+    }
+    if (HasExtension(path, ".map"))
+    {
+        error = "Moving AI maps are load-only; save as .pfvmap or .pfvrle";
+        return false;
+    }
+    if (HasExtension(path, ".pfvrle"))
+        return RunLength::Save(grid, path, error);
+    return BinaryMap::Save(grid, path, error);
+}
+
 void framebuffer_size_callback(GLFWwindow* window, int width, int height)
 {
     glViewport(0, 0, width, height);
@@ -427,6 +670,24 @@ void framebuffer_size_callback(GLFWwindow* window, int width, int height)
 
 void mouse_callback(GLFWwindow* window, double xpos, double ypos)
 {
+    // Dragging paints every tile the cursor passes into the current stroke
+    if (cursorEnabled && strokeActive)
+    {
+        int x, z;
+        if (PickTile(window, x, z) && (x != strokeX || z != strokeZ))
+        {
+            BrushShape shape = ui.GetBrushShape();
+            if (shape == BRUSH_LINE || shape == BRUSH_RECT)
+            {
+                strokeX = x;
+                strokeZ = z;
+            }
+            else
+                PaintBrush(x, z);
+        }
+        return;
+    }
+
     if (cursorEnabled) return;
 
     if (firstMouse)
@@ -455,6 +716,10 @@ void scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
 
 void mouse_button_callback(GLFWwindow* window, int button, int action, int mods)
 {
+    // Ends the stroke even when released over the UI
+    if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_RELEASE && strokeActive)
+        EndStroke();
+
     ImGuiIO& io = ImGui::GetIO();
     if (io.WantCaptureMouse)
         return;
@@ -467,45 +732,134 @@ void mouse_button_callback(GLFWwindow* window, int button, int action, int mods)
             creditWall->Hide();
         }
 
-        double mouseX, mouseY;
-        glfwGetCursorPos(window, &mouseX, &mouseY);
-
-        glm::mat4 view = camera.GetViewMatrix();
-        glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom),
-            (float)currentWidth / (float)currentHeight,
-            0.1f, 100.0f);
-
         int x, z;
-        if (Raycast::GetClickedTile(mouseX, mouseY, currentWidth, currentHeight,
-            camera.Position, view, projection, x, z))
+        if (PickTile(window, x, z))
         {
             EditMode mode = ui.GetCurrentMode();
 
-            if (mode == MODE_START)
-            {
-                grid.SetStart(x, z);
-                ui.SetStatus("Start point set");
-            }
-            else if (mode == MODE_GOAL)
-            {
-                grid.SetGoal(x, z);
-                ui.SetStatus("Goal point set");
-            }
-            else if (mode == MODE_OBSTACLE)
+            // Obstacle, clear and cost modes keep painting until release;
+            // placing the start or goal is a single edit
+            journal.BeginAction();
+            if (mode == MODE_OBSTACLE || mode == MODE_CLEAR || mode == MODE_COST)
             {
-                if (grid.GetTile(x, z) != START && grid.GetTile(x, z) != GOAL)
-                {
-                    grid.SetTile(x, z, OBSTACLE);
-                    ui.SetStatus("Obstacle placed");
-                }
+                anchorX = strokeX = x;
+                anchorZ = strokeZ = z;
+                strokeActive = true;
+
+                BrushShape shape = ui.GetBrushShape();
+                if (shape != BRUSH_LINE && shape != BRUSH_RECT)
+                    PaintBrush(x, z);
+                // A fill is done on press; it may touch the whole map
+                if (shape == BRUSH_FILL)
+                    EndStroke();
             }
-            else if (mode == MODE_CLEAR)
+            else
             {
-                if (grid.GetTile(x, z) == START) grid.ClearStart();
-                if (grid.GetTile(x, z) == GOAL) grid.ClearGoal();
-                grid.SetTile(x, z, EMPTY);
-                ui.SetStatus("Tile cleared");
+                EditTile(x, z);
+                journal.EndAction();
             }
         }
     }
-}
\ No newline at end of file
+}
+
+bool PickTile(GLFWwindow* window, int& x, int& z)
+{
+    double mouseX, mouseY;
+    glfwGetCursorPos(window, &mouseX, &mouseY);
+
+    glm::mat4 view = camera.GetViewMatrix();
+    glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom),
+        (float)currentWidth / (float)currentHeight,
+        0.1f, 100.0f);
+
+    return Raycast::GetClickedTile(grid, mouseX, mouseY, currentWidth, currentHeight,
+        camera.Position, view, projection, x, z);
+}
+
+void EditTile(int x, int z)
+{
+    strokeX = x;
+    strokeZ = z;
+    EditMode mode = ui.GetCurrentMode();
+
+    if (mode == MODE_START)
+    {
+        grid.SetStart(x, z);
+        ui.SetStatus("Start point set");
+    }
+    else if (mode == MODE_GOAL)
+    {
+        grid.SetGoal(x, z);
+        ui.SetStatus("Goal point set");
+    }
+    else if (mode == MODE_OBSTACLE)
+    {
+        if (grid.GetTile(x, z) != START && grid.GetTile(x, z) != GOAL)
+        {
+            grid.SetTile(x, z, OBSTACLE);
+            ui.SetStatus("Obstacle placed");
+        }
+    }
+    else if (mode == MODE_CLEAR)
+    {
+        if (grid.GetTile(x, z) == START) grid.ClearStart();
+        if (grid.GetTile(x, z) == GOAL) grid.ClearGoal();
+        grid.SetTile(x, z, EMPTY);
+        ui.SetStatus("Tile cleared");
+    }
+    else if (mode == MODE_COST)
+    {
+        grid.SetCost(x, z, ui.GetPaintCost());
+        ui.SetStatus("Cost set to " + std::to_string(ui.GetPaintCost()));
+    }
+}
+
+CellId PaintBrush(int x, int z)
+{
+    strokeX = x;
+    strokeZ = z;
+    EditMode mode = ui.GetCurrentMode();
+    TilePaint paint = mode == MODE_COST ? TilePaint::Cost(ui.GetPaintCost())
+        : TilePaint(mode == MODE_OBSTACLE ? OBSTACLE : EMPTY);
+
+    CellId changed = 0;
+    switch (ui.GetBrushShape())
+    {
+    case BRUSH_TILE:
+        EditTile(x, z);
+        return 1;
+    case BRUSH_LINE:
+        changed = grid.DrawLine(anchorX, anchorZ, x, z, paint);
+        break;
+    case BRUSH_RECT:
+        changed = grid.FillRect(anchorX, anchorZ, x, z, paint);
+        break;
+    case BRUSH_CIRCLE:
+        changed = grid.FillCircle(x, z, ui.GetBrushRadius(), paint);
+        break;
+    case BRUSH_FILL:
+        changed = grid.FloodFill(x, z, paint);
+        break;
+    }
+
+    const char* action = mode == MODE_COST ? "weighted" : mode == MODE_OBSTACLE ? "blocked" : "cleared";
+    ui.SetStatus(std::to_string(changed) + (changed == 1 ? " tile " : " tiles ") + action);
+    return changed;
+}
+
+void EndStroke()
+{
+    // Line and rectangle brushes are applied once, on release
+    BrushShape shape = ui.GetBrushShape();
+    if (shape == BRUSH_LINE || shape == BRUSH_RECT)
+        PaintBrush(strokeX, strokeZ);
+
+    strokeActive = false;
+    journal.EndAction();
+}
+
+void UndoEdit(bool redo)
+{
+    if (redo ? journal.Redo() : journal.Undo())
+        ui.SetStatus(redo ? "Redo" : "Undo");
+}